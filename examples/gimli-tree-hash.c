@@ -0,0 +1,248 @@
+#include <lithium/gimli_tree.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/*
+ * Each segment of SEGMENT_LEAVES whole leaves is a perfect subtree. The input
+ * is read in batches of one segment per CPU, which are queued for a fixed pool
+ * of worker threads, and the main thread takes segments too until the batch
+ * is done. The segment roots are then added to the tree in order.
+ */
+#define SEGMENT_LEAVES 256U
+#define SEGMENT_LEN (SEGMENT_LEAVES * GIMLI_TREE_LEAF_LEN)
+#define MAX_THREADS 64
+
+struct segment
+{
+    const unsigned char *m;
+    unsigned char root[GIMLI_TREE_HASH_LEN];
+};
+
+/*
+ * The queue holds one batch of segments at a time. Workers take the next
+ * segment until all n are taken, and the last one to finish signals done.
+ * Setting segments to NULL stops the workers.
+ */
+struct pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t queued;
+    pthread_cond_t done;
+    pthread_t threads[MAX_THREADS];
+    struct segment *segments;
+    size_t nthreads;
+    size_t n;
+    size_t next;
+    size_t pending;
+};
+
+/* Process segments until none are left to take. Called with the lock held. */
+static void pool_drain(struct pool *p)
+{
+    while ((p->segments != NULL) && (p->next < p->n))
+    {
+        struct segment *s = &p->segments[p->next++];
+        pthread_mutex_unlock(&p->lock);
+        gimli_tree_hash(s->root, s->m, SEGMENT_LEN);
+        pthread_mutex_lock(&p->lock);
+        if (--p->pending == 0)
+        {
+            pthread_cond_signal(&p->done);
+        }
+    }
+}
+
+static void *worker(void *arg)
+{
+    struct pool *p = arg;
+    pthread_mutex_lock(&p->lock);
+    while (p->segments != NULL)
+    {
+        pool_drain(p);
+        if (p->segments != NULL)
+        {
+            pthread_cond_wait(&p->queued, &p->lock);
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/*
+ * Start up to nthreads workers. If none start, the main thread does all of
+ * the work in pool_run.
+ */
+static void pool_start(struct pool *p, struct segment *segments,
+                       size_t nthreads)
+{
+    p->segments = segments;
+    p->n = 0;
+    p->next = 0;
+    p->pending = 0;
+    for (p->nthreads = 0; p->nthreads < nthreads; ++p->nthreads)
+    {
+        if (pthread_create(&p->threads[p->nthreads], NULL, worker, p) != 0)
+        {
+            break;
+        }
+    }
+}
+
+/* Hash the first n segments and wait until they are all done. */
+static void pool_run(struct pool *p, size_t n)
+{
+    pthread_mutex_lock(&p->lock);
+    p->n = n;
+    p->next = 0;
+    p->pending = n;
+    pthread_cond_broadcast(&p->queued);
+    pool_drain(p);
+    while (p->pending > 0)
+    {
+        pthread_cond_wait(&p->done, &p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pool_stop(struct pool *p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->segments = NULL;
+    pthread_cond_broadcast(&p->queued);
+    pthread_mutex_unlock(&p->lock);
+    for (size_t i = 0; i < p->nthreads; ++i)
+    {
+        pthread_join(p->threads[i], NULL);
+    }
+    p->nthreads = 0;
+}
+
+static ssize_t read_full(int fd, unsigned char *buf, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        ssize_t nread = read(fd, &buf[total], len - total);
+        if (nread < 0)
+        {
+            return nread;
+        }
+        if (nread == 0)
+        {
+            break;
+        }
+        total += (size_t)nread;
+    }
+    return (ssize_t)total;
+}
+
+static ssize_t hash_fd(int fd, unsigned char *buf, struct pool *pool,
+                       size_t nsegments)
+{
+    gimli_tree_state state;
+    gimli_tree_init(&state);
+
+    for (;;)
+    {
+        ssize_t nread = read_full(fd, buf, nsegments * SEGMENT_LEN);
+        if (nread < 0)
+        {
+            return nread;
+        }
+
+        size_t full = (size_t)nread / SEGMENT_LEN;
+        for (size_t i = 0; i < full; ++i)
+        {
+            pool->segments[i].m = &buf[i * SEGMENT_LEN];
+        }
+        pool_run(pool, full);
+        for (size_t i = 0; i < full; ++i)
+        {
+            /* Segments are whole and aligned, so this cannot fail. */
+            (void)gimli_tree_update_subtree(&state, pool->segments[i].root,
+                                            SEGMENT_LEAVES);
+        }
+
+        if ((size_t)nread < nsegments * SEGMENT_LEN)
+        {
+            gimli_tree_update(&state, &buf[full * SEGMENT_LEN],
+                              (size_t)nread - full * SEGMENT_LEN);
+            break;
+        }
+    }
+
+    unsigned char root[GIMLI_TREE_HASH_LEN];
+    gimli_tree_final(&state, root);
+    for (size_t i = 0; i < sizeof root; ++i)
+    {
+        printf("%02hhx", root[i]);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = ncpus < 1             ? 1
+                      : ncpus > MAX_THREADS ? MAX_THREADS
+                                            : (size_t)ncpus;
+
+    unsigned char *buf = malloc(nthreads * SEGMENT_LEN);
+    if (buf == NULL)
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    struct segment segments[MAX_THREADS];
+    struct pool pool = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .queued = PTHREAD_COND_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+    };
+    pool_start(&pool, segments, nthreads - 1);
+
+    int exitcode = EXIT_SUCCESS;
+    if (argc < 2)
+    {
+        if (hash_fd(STDIN_FILENO, buf, &pool, nthreads) < 0)
+        {
+            perror("read");
+            exitcode = EXIT_FAILURE;
+        }
+        else
+        {
+            printf("  -\n");
+        }
+    }
+    else
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            int fd = open(argv[i], O_RDONLY);
+            if (fd < 0)
+            {
+                perror("open");
+                exitcode = EXIT_FAILURE;
+                break;
+            }
+            if (hash_fd(fd, buf, &pool, nthreads) < 0)
+            {
+                perror("read");
+                close(fd);
+                exitcode = EXIT_FAILURE;
+                break;
+            }
+            printf("  %s\n", argv[i]);
+            close(fd);
+        }
+    }
+
+    pool_stop(&pool);
+    free(buf);
+    return exitcode;
+}
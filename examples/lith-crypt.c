@@ -0,0 +1,436 @@
+#include <lithium/gimli_stream.h>
+#include <lithium/random.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Encrypts or decrypts a file with gimli_stream. An encrypted file is a random
+ * stream prefix followed by each chunk's ciphertext and tag. Every chunk
+ * except the last holds CHUNK_LEN bytes of plaintext, and an empty file is a
+ * single empty last chunk.
+ *
+ * The input is read in batches of one chunk per CPU, which are queued for a
+ * fixed pool of worker threads. The next batch is read while the workers
+ * take chunks from the queue, and then the main thread takes chunks too until
+ * the batch is done. The output of a batch is written in order. One byte more
+ * than the batch is read, so the last chunk is known when its batch is read.
+ * Decryption stops at the first chunk that is not authentic, and the output
+ * file is removed.
+ */
+#define CHUNK_LEN (64U * 1024U)
+#define STORED_LEN (CHUNK_LEN + GIMLI_STREAM_TAG_LEN)
+#define MAX_THREADS 64
+
+struct stream
+{
+    bool decrypt;
+    unsigned char prefix[GIMLI_STREAM_PREFIX_LEN];
+    unsigned char key[GIMLI_STREAM_KEY_LEN];
+};
+
+struct chunk
+{
+    const unsigned char *in;
+    unsigned char *out;
+    size_t len; /* plaintext length */
+    uint32_t index;
+    bool last;
+    bool ok;
+    unsigned char pad[2];
+};
+
+/*
+ * The queue holds one batch of chunks at a time. Workers take the next chunk
+ * until all n are taken, and the last one to finish signals done. Setting
+ * chunks to NULL stops the workers.
+ */
+struct pool
+{
+    pthread_mutex_t lock;
+    pthread_cond_t queued;
+    pthread_cond_t done;
+    pthread_t threads[MAX_THREADS];
+    const struct stream *stream;
+    struct chunk *chunks;
+    size_t nthreads;
+    size_t n;
+    size_t next;
+    size_t pending;
+};
+
+static void crypt_chunk(const struct stream *s, struct chunk *c)
+{
+    if (s->decrypt)
+    {
+        c->ok = gimli_stream_decrypt_chunk(c->out, c->in, c->len,
+                                           &c->in[c->len], c->index, c->last,
+                                           s->prefix, s->key);
+    }
+    else
+    {
+        gimli_stream_encrypt_chunk(c->out, &c->out[c->len], c->in, c->len,
+                                   c->index, c->last, s->prefix, s->key);
+        c->ok = true;
+    }
+}
+
+/* Process chunks until none are left to take. Called with the lock held. */
+static void pool_drain(struct pool *p)
+{
+    while ((p->chunks != NULL) && (p->next < p->n))
+    {
+        struct chunk *c = &p->chunks[p->next++];
+        pthread_mutex_unlock(&p->lock);
+        crypt_chunk(p->stream, c);
+        pthread_mutex_lock(&p->lock);
+        if (--p->pending == 0)
+        {
+            pthread_cond_signal(&p->done);
+        }
+    }
+}
+
+static void *worker(void *arg)
+{
+    struct pool *p = arg;
+    pthread_mutex_lock(&p->lock);
+    while (p->chunks != NULL)
+    {
+        pool_drain(p);
+        if (p->chunks != NULL)
+        {
+            pthread_cond_wait(&p->queued, &p->lock);
+        }
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/*
+ * Start up to nthreads workers. If none start, the main thread does all of
+ * the work in pool_wait.
+ */
+static void pool_start(struct pool *p, const struct stream *s,
+                       struct chunk *chunks, size_t nthreads)
+{
+    p->stream = s;
+    p->chunks = chunks;
+    p->n = 0;
+    p->next = 0;
+    p->pending = 0;
+    for (p->nthreads = 0; p->nthreads < nthreads; ++p->nthreads)
+    {
+        if (pthread_create(&p->threads[p->nthreads], NULL, worker, p) != 0)
+        {
+            break;
+        }
+    }
+}
+
+static void pool_submit(struct pool *p, size_t n)
+{
+    pthread_mutex_lock(&p->lock);
+    p->n = n;
+    p->next = 0;
+    p->pending = n;
+    pthread_cond_broadcast(&p->queued);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pool_wait(struct pool *p)
+{
+    pthread_mutex_lock(&p->lock);
+    pool_drain(p);
+    while (p->pending > 0)
+    {
+        pthread_cond_wait(&p->done, &p->lock);
+    }
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void pool_stop(struct pool *p)
+{
+    pthread_mutex_lock(&p->lock);
+    p->chunks = NULL;
+    pthread_cond_broadcast(&p->queued);
+    pthread_mutex_unlock(&p->lock);
+    for (size_t i = 0; i < p->nthreads; ++i)
+    {
+        pthread_join(p->threads[i], NULL);
+    }
+    p->nthreads = 0;
+}
+
+static ssize_t read_full(int fd, unsigned char *buf, size_t len)
+{
+    size_t total = 0;
+    while (total < len)
+    {
+        ssize_t nread = read(fd, &buf[total], len - total);
+        if (nread < 0)
+        {
+            return nread;
+        }
+        if (nread == 0)
+        {
+            break;
+        }
+        total += (size_t)nread;
+    }
+    return (ssize_t)total;
+}
+
+static bool write_full(int fd, const unsigned char *buf, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t nwritten = write(fd, buf, len);
+        if (nwritten < 0)
+        {
+            return false;
+        }
+        buf += nwritten;
+        len -= (size_t)nwritten;
+    }
+    return true;
+}
+
+/*
+ * Split a batch of total input bytes into chunks. Returns the number of chunks,
+ * or 0 if the input is not a valid encrypted stream.
+ */
+static size_t split_batch(struct chunk *chunks, const struct stream *s,
+                          const unsigned char *in, unsigned char *out,
+                          size_t total, bool final, uint64_t first)
+{
+    const size_t in_len = s->decrypt ? STORED_LEN : CHUNK_LEN;
+    const size_t out_len = s->decrypt ? CHUNK_LEN : STORED_LEN;
+    size_t n = (total + in_len - 1) / in_len;
+    if (n == 0)
+    {
+        /* Only an empty plaintext has no input bytes. */
+        if (s->decrypt)
+        {
+            return 0;
+        }
+        n = 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t len = total - i * in_len;
+        if (len > in_len)
+        {
+            len = in_len;
+        }
+        if (s->decrypt)
+        {
+            if (len < GIMLI_STREAM_TAG_LEN)
+            {
+                return 0;
+            }
+            len -= GIMLI_STREAM_TAG_LEN;
+        }
+        if (first + i > UINT32_MAX)
+        {
+            return 0;
+        }
+        chunks[i].in = &in[i * in_len];
+        chunks[i].out = &out[i * out_len];
+        chunks[i].len = len;
+        chunks[i].index = (uint32_t)(first + i);
+        chunks[i].last = final && (i == n - 1);
+    }
+    return n;
+}
+
+static int crypt_fd(int infd, int outfd, const struct stream *s,
+                    size_t nthreads)
+{
+    const size_t in_len = s->decrypt ? STORED_LEN : CHUNK_LEN;
+    const size_t out_len = s->decrypt ? CHUNK_LEN : STORED_LEN;
+    const size_t cap = nthreads * in_len + 1;
+    struct chunk chunks[MAX_THREADS];
+    struct pool pool = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .queued = PTHREAD_COND_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+        .nthreads = 0,
+    };
+    unsigned char *in[2] = {malloc(cap), malloc(cap)};
+    unsigned char *out = malloc(nthreads * out_len);
+    ssize_t nread;
+    size_t total;
+    uint64_t index = 0;
+    int exitcode = EXIT_FAILURE;
+
+    if ((in[0] == NULL) || (in[1] == NULL) || (out == NULL))
+    {
+        perror("malloc");
+        goto cleanup;
+    }
+
+    /* The main thread also works on each batch once the next one is read. */
+    pool_start(&pool, s, chunks, nthreads - 1);
+    nread = read_full(infd, in[0], cap);
+    total = (size_t)nread;
+    for (unsigned cur = 0;; cur ^= 1)
+    {
+        if (nread < 0)
+        {
+            perror("could not read input");
+            goto cleanup;
+        }
+        const bool final = total < cap;
+        const size_t n = split_batch(chunks, s, in[cur], out,
+                                     final ? total : cap - 1, final, index);
+        if (n == 0)
+        {
+            fprintf(stderr, "input is truncated or too large\n");
+            goto cleanup;
+        }
+        pool_submit(&pool, n);
+
+        /* Read the next batch, after the byte read ahead, while they work. */
+        if (!final)
+        {
+            in[cur ^ 1][0] = in[cur][cap - 1];
+            nread = read_full(infd, &in[cur ^ 1][1], cap - 1);
+            total = (size_t)nread + 1;
+        }
+
+        /* Stop at the first chunk that fails to decrypt. */
+        pool_wait(&pool);
+        size_t good = 0;
+        while ((good < n) && chunks[good].ok)
+        {
+            ++good;
+        }
+        if (good < n)
+        {
+            fprintf(stderr, "chunk %lu is not authentic\n",
+                    (unsigned long)(index + good));
+            goto cleanup;
+        }
+        const struct chunk *l = &chunks[n - 1];
+        const size_t len = (size_t)(l->out - out) + l->len +
+                           (s->decrypt ? 0 : GIMLI_STREAM_TAG_LEN);
+        if (!write_full(outfd, out, len))
+        {
+            perror("could not write output");
+            goto cleanup;
+        }
+        index += n;
+        if (final)
+        {
+            break;
+        }
+    }
+    exitcode = EXIT_SUCCESS;
+
+cleanup:
+    pool_stop(&pool);
+    free(in[0]);
+    free(in[1]);
+    free(out);
+    return exitcode;
+}
+
+int main(int argc, char **argv)
+{
+    if ((argc < 5) || (argv[1][0] != '-') ||
+        ((argv[1][1] != 'e') && (argv[1][1] != 'd')) || (argv[1][2] != '\0'))
+    {
+        fprintf(stderr,
+                "usage: %s -e|-d <key-file> <input-file> <output-file>\n"
+                "The key file holds %u random bytes.\n",
+                argv[0], (unsigned)GIMLI_STREAM_KEY_LEN);
+        return EXIT_FAILURE;
+    }
+
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = ncpus < 1             ? 1
+                      : ncpus > MAX_THREADS ? MAX_THREADS
+                                            : (size_t)ncpus;
+
+    int keyfd = -1, infd = -1, outfd = -1;
+    int exitcode = EXIT_FAILURE;
+    struct stream s;
+    s.decrypt = argv[1][1] == 'd';
+
+    keyfd = open(argv[2], O_RDONLY);
+    if (keyfd < 0)
+    {
+        perror("could not open the key file");
+        goto cleanup;
+    }
+    if (read_full(keyfd, s.key, sizeof s.key) != sizeof s.key)
+    {
+        fprintf(stderr, "could not read a %u-byte key\n",
+                (unsigned)sizeof s.key);
+        goto cleanup;
+    }
+
+    infd = open(argv[3], O_RDONLY);
+    if (infd < 0)
+    {
+        perror("could not open input file");
+        goto cleanup;
+    }
+    outfd = open(argv[4], O_CREAT | O_WRONLY | O_TRUNC, 0600);
+    if (outfd < 0)
+    {
+        perror("could not create output file");
+        goto cleanup;
+    }
+
+    if (s.decrypt)
+    {
+        if (read_full(infd, s.prefix, sizeof s.prefix) != sizeof s.prefix)
+        {
+            fprintf(stderr, "input is truncated\n");
+            goto cleanup;
+        }
+    }
+    else
+    {
+        lith_random_bytes(s.prefix, sizeof s.prefix);
+        if (!write_full(outfd, s.prefix, sizeof s.prefix))
+        {
+            perror("could not write output");
+            goto cleanup;
+        }
+    }
+
+    exitcode = crypt_fd(infd, outfd, &s, nthreads);
+
+cleanup:
+    memset(s.key, 0, sizeof s.key);
+    if ((keyfd >= 0) && (close(keyfd) < 0))
+    {
+        perror("failed to close key file");
+        exitcode = EXIT_FAILURE;
+    }
+    if ((infd >= 0) && (close(infd) < 0))
+    {
+        perror("failed to close input file");
+        exitcode = EXIT_FAILURE;
+    }
+    if ((outfd >= 0) && (close(outfd) < 0))
+    {
+        perror("failed to close output file");
+        exitcode = EXIT_FAILURE;
+    }
+    /* Don't leave a partial output behind. */
+    if ((outfd >= 0) && (exitcode != EXIT_SUCCESS))
+    {
+        (void)unlink(argv[4]);
+    }
+    return exitcode;
+}
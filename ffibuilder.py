@@ -6,6 +6,7 @@ ffibuilder = cffi.FFI()
 c_headers = [
     "lithium/gimli.h",
     "lithium/gimli_state.h",
+    "lithium/iovec.h",
     "lithium/gimli_hash.h",
     "lithium/sign.h",
 ]
@@ -16,8 +17,11 @@ ffibuilder.set_source(
     include_dirs=["include"],
     sources=[
         "src/gimli.c",
+        "src/gimli_x.c",
         "src/gimli_common.c",
         "src/gimli_hash.c",
+        "src/gimli_hash_many.c",
+        "src/gimli_aead.c",
         "src/fe.c",
         "src/memzero.c",
         "src/x25519.c",
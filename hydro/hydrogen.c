@@ -97,6 +97,33 @@ int hydro_hash_hash(uint8_t *out, size_t out_len, const void *in_,
     return 0;
 }
 
+int hydro_hash_midstate_init(hydro_hash_midstate *mid,
+                             const char ctx[hydro_hash_CONTEXTBYTES],
+                             const uint8_t key[hydro_hash_KEYBYTES])
+{
+    return hydro_hash_init(&mid->st, ctx, key);
+}
+
+int hydro_hash_init_midstate(hydro_hash_state *state,
+                             const hydro_hash_midstate *mid)
+{
+    *state = mid->st;
+    return 0;
+}
+
+int hydro_hash_hash_midstate(uint8_t *out, size_t out_len, const void *in_,
+                             size_t in_len, const hydro_hash_midstate *mid)
+{
+    hydro_hash_state st;
+    if (hydro_hash_init_midstate(&st, mid) != 0 ||
+        hydro_hash_update(&st, in_, in_len) != 0 ||
+        hydro_hash_final(&st, out, out_len) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
 #define hydro_sign_CHALLENGEBYTES 32
 #define hydro_sign_NONCEBYTES 32
 #define hydro_sign_PREHASHBYTES 64
@@ -54,6 +54,29 @@ int hydro_hash_hash(uint8_t *out, size_t out_len, const void *in_,
                     size_t in_len, const char ctx[hydro_hash_CONTEXTBYTES],
                     const uint8_t key[hydro_hash_KEYBYTES]);
 
+/*
+ * The state after hydro_hash_init with a given ctx and key. The context and
+ * key fill whole blocks, so hydro_hash_init costs four permutations before
+ * any input. To compute many hashes with the same ctx and key, initialize a
+ * midstate once and start each hash from a copy of it instead. The midstate
+ * is derived from the key, so clear it when it is no longer needed.
+ */
+typedef struct hydro_hash_midstate
+{
+    hydro_hash_state st;
+} hydro_hash_midstate;
+
+int hydro_hash_midstate_init(hydro_hash_midstate *mid,
+                             const char ctx[hydro_hash_CONTEXTBYTES],
+                             const uint8_t key[hydro_hash_KEYBYTES]);
+
+/* The same as hydro_hash_init with the ctx and key of the midstate. */
+int hydro_hash_init_midstate(hydro_hash_state *state,
+                             const hydro_hash_midstate *mid);
+
+int hydro_hash_hash_midstate(uint8_t *out, size_t out_len, const void *in_,
+                             size_t in_len, const hydro_hash_midstate *mid);
+
 #define hydro_sign_BYTES 64
 #define hydro_sign_CONTEXTBYTES 8
 #define hydro_sign_PUBLICKEYBYTES 32
@@ -1,7 +1,10 @@
+#include "hydrogen.h"
+
 #include <lithium/random.h>
 #include <lithium/sign.h>
 
 #include <assert.h>
+#include <string.h>
 
 /*
  * Part of liblithium, under the Apache License v2.0.
@@ -64,7 +67,41 @@ static void test_sign(void)
     assert(lith_sign_verify(sig, msg, 0, public_key));
 }
 
+static void test_hash_midstate(void)
+{
+    static const char ctx[hydro_hash_CONTEXTBYTES] = "midstate";
+    uint8_t key[hydro_hash_KEYBYTES];
+    uint8_t msg[100];
+    uint8_t h1[hydro_hash_BYTES], h2[hydro_hash_BYTES];
+    hydro_hash_midstate keyed, unkeyed;
+    size_t len;
+
+    hydro_hash_keygen(key);
+    lith_random_bytes(msg, sizeof msg);
+    hydro_hash_midstate_init(&keyed, ctx, key);
+    hydro_hash_midstate_init(&unkeyed, NULL, NULL);
+    for (len = 0; len <= sizeof msg; len += 7)
+    {
+        hydro_hash_state st;
+
+        hydro_hash_hash(h1, sizeof h1, msg, len, ctx, key);
+        assert(hydro_hash_hash_midstate(h2, sizeof h2, msg, len, &keyed) == 0);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+
+        hydro_hash_init_midstate(&st, &keyed);
+        hydro_hash_update(&st, msg, len / 2);
+        hydro_hash_update(&st, &msg[len / 2], len - len / 2);
+        hydro_hash_final(&st, h2, sizeof h2);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+
+        hydro_hash_hash(h1, sizeof h1, msg, len, NULL, NULL);
+        hydro_hash_hash_midstate(h2, sizeof h2, msg, len, &unkeyed);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+    }
+}
+
 int main(void)
 {
     test_sign();
+    test_hash_midstate();
 }
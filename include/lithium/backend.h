@@ -0,0 +1,19 @@
+#ifndef LITHIUM_BACKEND_H
+#define LITHIUM_BACKEND_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Returns the name of the Gimli permutation backend in use: "scalar", "sse2",
+ * "ssse3", "avx2", "avx512", "neon", or "altivec".
+ *
+ * When liblithium is built with LITH_DISPATCH, every x86 backend is compiled
+ * into the library and the best one supported by the CPU is selected once at
+ * startup. Otherwise, the backend is fixed at compile time.
+ */
+const char *lith_backend(void);
+
+#endif /* LITHIUM_BACKEND_H */
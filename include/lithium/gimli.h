@@ -14,6 +14,20 @@
 
 void gimli(uint32_t state[GIMLI_WORDS]);
 
+/*
+ * Permute 2, 4, 8, or 16 independent Gimli states at once.
+ *
+ * The states are interleaved: word w of state l is state[w * lanes + l],
+ * where lanes is 2, 4, 8, or 16.
+ */
+void gimli_x2(uint32_t state[GIMLI_WORDS * 2]);
+
+void gimli_x4(uint32_t state[GIMLI_WORDS * 4]);
+
+void gimli_x8(uint32_t state[GIMLI_WORDS * 8]);
+
+void gimli_x16(uint32_t state[GIMLI_WORDS * 16]);
+
 /* cffi:end */
 
 #endif /* LITHIUM_GIMLI_H */
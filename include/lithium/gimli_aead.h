@@ -7,6 +7,7 @@
  */
 
 #include <lithium/gimli_state.h>
+#include <lithium/iovec.h>
 
 #include <stdbool.h>
 #include <stddef.h>
@@ -24,14 +25,56 @@ void gimli_aead_update_ad(gimli_state *g, const unsigned char *ad,
 
 void gimli_aead_final_ad(gimli_state *g);
 
+/*
+ * The _words variants process 32-bit words, and are the same as the byte
+ * functions with each word stored in little-endian order. Whole words are
+ * combined with the state directly, which avoids per-byte work on targets
+ * where bytes are not addressable, such as those with CHAR_BIT == 16.
+ */
+void gimli_aead_update_ad_words(gimli_state *g, const uint32_t *ad,
+                                size_t nwords);
+
 void gimli_aead_encrypt_update(gimli_state *g, unsigned char *c,
                                const unsigned char *m, size_t len);
 
+void gimli_aead_encrypt_update_words(gimli_state *g, uint32_t *c,
+                                     const uint32_t *m, size_t nwords);
+
 void gimli_aead_encrypt_final(gimli_state *g, unsigned char *t, size_t tlen);
 
 void gimli_aead_decrypt_update(gimli_state *g, unsigned char *m,
                                const unsigned char *c, size_t len);
 
+void gimli_aead_decrypt_update_words(gimli_state *g, uint32_t *m,
+                                     const uint32_t *c, size_t nwords);
+
+/*
+ * Decrypt like gimli_aead_decrypt_update, and absorb the plaintext into the
+ * Gimli-Hash state h, like gimli_hash_update, in the same pass. When both
+ * states are at the same offset within a block, each block is decrypted and
+ * absorbed while it is in registers, and the two permutations are
+ * interleaved. The plaintext is not authentic until both the tag and
+ * whatever uses the hash have been checked.
+ */
+void gimli_aead_decrypt_update_hash(gimli_state *g, gimli_state *h,
+                                    unsigned char *m, const unsigned char *c,
+                                    size_t len);
+
+/*
+ * The _iov variants process the n fragments of a scatter/gather buffer in
+ * order. They are the same as calling the byte functions on each fragment,
+ * but a block that spans fragments is gathered and processed as a whole
+ * block. The output fragments must have the same lengths as the input
+ * fragments, and may be the same array to process the data in place.
+ */
+void gimli_aead_update_ad_iov(gimli_state *g, const lith_iovec *ad, size_t n);
+
+void gimli_aead_encrypt_update_iov(gimli_state *g, const lith_iovec *c,
+                                   const lith_iovec *m, size_t n);
+
+void gimli_aead_decrypt_update_iov(gimli_state *g, const lith_iovec *m,
+                                   const lith_iovec *c, size_t n);
+
 bool gimli_aead_decrypt_final(gimli_state *g, const unsigned char *t,
                               size_t tlen);
 
@@ -47,4 +90,35 @@ bool gimli_aead_decrypt(unsigned char *m, const unsigned char *c, size_t len,
                         const unsigned char n[GIMLI_AEAD_NONCE_LEN],
                         const unsigned char k[GIMLI_AEAD_KEY_LEN]);
 
+/*
+ * One message of a batch. The key and nonce may differ for each message. in
+ * and out are len bytes long and may be the same buffer. Encryption writes
+ * the tag to t, and decryption reads the tag from t.
+ */
+typedef struct
+{
+    const unsigned char *n;
+    const unsigned char *k;
+    const unsigned char *ad;
+    size_t adlen;
+    const unsigned char *in;
+    unsigned char *out;
+    size_t len;
+    unsigned char *t;
+} gimli_aead_item;
+
+/*
+ * Encrypt or decrypt n independent messages, with tlen-byte tags. The results
+ * are the same as calling gimli_aead_encrypt or gimli_aead_decrypt on each
+ * message, but the messages share the lanes of the multi-state permutation
+ * when vector extensions are available. Decryption sets ok[i] to whether the
+ * tag of message i is valid, clearing its output if not, and returns true if
+ * all of the tags are valid.
+ */
+void gimli_aead_encrypt_many(const gimli_aead_item items[], size_t n,
+                             size_t tlen);
+
+bool gimli_aead_decrypt_many(bool ok[], const gimli_aead_item items[],
+                             size_t n, size_t tlen);
+
 #endif /* LITHIUM_GIMLI_AEAD_H */
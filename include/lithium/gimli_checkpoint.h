@@ -0,0 +1,60 @@
+#ifndef LITHIUM_GIMLI_CHECKPOINT_H
+#define LITHIUM_GIMLI_CHECKPOINT_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Checkpointed hashing. While hashing, a checkpoint entry is produced every
+ * interval bytes, holding the position and the exported hash state at that
+ * position. Store the entries in order, e.g., in a sidecar index file next to
+ * the input. When the input later changes, resume from the last entry whose
+ * position is at or before the first changed byte, and hash only the rest.
+ *
+ * The hash state is a gimli_hash_state, which is also a lith_sign_state, so
+ * the result can be finished with gimli_hash_final or lith_sign_final_create.
+ *
+ * Entries have the same portable, checked layout as gimli_hash_export, with
+ * the position covered by the check value. Nothing in an entry identifies
+ * the input, so resuming from an entry for different input, or from a
+ * position after a change, gives a wrong hash.
+ */
+
+#define GIMLI_CHECKPOINT_LEN (8 + GIMLI_HASH_EXPORT_LEN)
+
+typedef struct
+{
+    uint64_t pos;
+    uint64_t interval;
+    gimli_hash_state hash;
+    uint32_t pad;
+} gimli_checkpoint_state;
+
+/* Called with each checkpoint entry, in order. */
+typedef void
+gimli_checkpoint_fn(void *ctx, const unsigned char entry[GIMLI_CHECKPOINT_LEN]);
+
+/* interval must not be 0. */
+void gimli_checkpoint_init(gimli_checkpoint_state *c, uint64_t interval);
+
+void gimli_checkpoint_update(gimli_checkpoint_state *c, const unsigned char *m,
+                             size_t len, gimli_checkpoint_fn *fn, void *ctx);
+
+/*
+ * Resume from an entry that was produced with the same interval. Afterward,
+ * c->pos is the position of the entry, so continue with the input from there.
+ * Returns false, leaving c unchanged, if the entry is not valid.
+ */
+bool gimli_checkpoint_resume(gimli_checkpoint_state *c,
+                             const unsigned char entry[GIMLI_CHECKPOINT_LEN],
+                             uint64_t interval);
+
+#endif /* LITHIUM_GIMLI_CHECKPOINT_H */
@@ -0,0 +1,80 @@
+#ifndef LITHIUM_GIMLI_CHUNKER_H
+#define LITHIUM_GIMLI_CHUNKER_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Content-defined chunking, for deduplication and delta updates. A gear
+ * rolling hash of the last 32 bytes of input chooses the chunk boundaries, so
+ * they depend only on nearby content, and inserting or removing bytes only
+ * changes the chunks around the edit. Boundaries are normalized as in
+ * FastCDC: no chunk is shorter than GIMLI_CHUNK_MIN_LEN or longer than
+ * GIMLI_CHUNK_MAX_LEN, and chunks are about GIMLI_CHUNK_AVG_LEN bytes long
+ * on average.
+ *
+ * Each chunk is hashed with Gimli-Hash in the same pass: the input is scanned
+ * for the next boundary and then absorbed into the digest of the chunk while
+ * it is still in the cache. The digest is the same as gimli_hash of the
+ * chunk with GIMLI_CHUNK_DIGEST_LEN bytes of output.
+ *
+ * The rolling hash is derived from a key. Boundaries can reveal information
+ * about the content, so use a secret key if the chunk lengths are visible to
+ * others, and the same key wherever chunks should match.
+ *
+ * To sign the list of chunks, pass the encoded entries of the chunks, in
+ * order, to lith_sign_update.
+ */
+
+#define GIMLI_CHUNK_MIN_LEN 2048U
+#define GIMLI_CHUNK_AVG_LEN 8192U
+#define GIMLI_CHUNK_MAX_LEN 65536U
+#define GIMLI_CHUNK_KEY_LEN 16U
+#define GIMLI_CHUNK_DIGEST_LEN 32U
+#define GIMLI_CHUNK_ENTRY_LEN (16U + GIMLI_CHUNK_DIGEST_LEN)
+
+typedef struct
+{
+    uint64_t offset;
+    uint64_t len;
+    unsigned char digest[GIMLI_CHUNK_DIGEST_LEN];
+} gimli_chunk;
+
+typedef struct
+{
+    uint64_t offset;
+    uint32_t gear[256];
+    gimli_hash_state hash;
+    uint32_t len;
+    uint32_t roll;
+    uint32_t pad;
+} gimli_chunker_state;
+
+/* Called with each chunk, in order. */
+typedef void gimli_chunk_fn(void *ctx, const gimli_chunk *chunk);
+
+void gimli_chunker_init(gimli_chunker_state *c,
+                        const unsigned char key[GIMLI_CHUNK_KEY_LEN]);
+
+void gimli_chunker_update(gimli_chunker_state *c, const unsigned char *m,
+                          size_t len, gimli_chunk_fn *fn, void *ctx);
+
+/* Emit the last chunk. Empty input has no chunks. */
+void gimli_chunker_final(gimli_chunker_state *c, gimli_chunk_fn *fn,
+                         void *ctx);
+
+/*
+ * Encode a chunk as its offset and length as 8-byte little-endian integers,
+ * followed by its digest.
+ */
+void gimli_chunk_encode(unsigned char entry[GIMLI_CHUNK_ENTRY_LEN],
+                        const gimli_chunk *chunk);
+
+#endif /* LITHIUM_GIMLI_CHUNKER_H */
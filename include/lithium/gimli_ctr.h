@@ -0,0 +1,82 @@
+#ifndef LITHIUM_GIMLI_CTR_H
+#define LITHIUM_GIMLI_CTR_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Authenticated encryption in counter mode with a parallel MAC, for bulk data
+ * where the serial duplex of gimli_aead is too slow.
+ *
+ * The nonce and key are permuted once into a secret base state. Block i of
+ * the keystream is the rate of the base state permuted with i and a domain
+ * tag in its capacity. The MAC is the XOR of the same function of each
+ * 16-byte block of ciphertext and associated data, with the block in the
+ * rate, and the tag is the same function of the XOR and the lengths. No block
+ * depends on another, so the blocks are processed in the lanes of the
+ * multi-state permutation, and a message can also be split across threads:
+ * each thread encrypts and MACs a range of whole blocks with gimli_ctr_xor and
+ * gimli_ctr_mac_update, and the MAC sums of the ranges are XORed together.
+ *
+ * A nonce must never be reused with the same key.
+ */
+
+#define GIMLI_CTR_KEY_LEN 32U
+#define GIMLI_CTR_NONCE_LEN 16U
+#define GIMLI_CTR_TAG_LEN 16U
+#define GIMLI_CTR_BLOCK_LEN 16U
+
+typedef struct
+{
+    uint32_t base[GIMLI_WORDS];
+} gimli_ctr_state;
+
+void gimli_ctr_init(gimli_ctr_state *s,
+                    const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                    const unsigned char k[GIMLI_CTR_KEY_LEN]);
+
+/*
+ * XOR len bytes of keystream, starting at block index block, into in, and
+ * write the result to out, which may be in. Encryption and decryption are the
+ * same.
+ */
+void gimli_ctr_xor(const gimli_ctr_state *s, unsigned char *out,
+                   const unsigned char *in, size_t len, uint64_t block);
+
+/*
+ * XOR the MAC of len bytes of ciphertext, starting at block index block, into
+ * sum, which starts as zeros. Only the end of the ciphertext may be a partial
+ * block.
+ */
+void gimli_ctr_mac_update(const gimli_ctr_state *s,
+                          unsigned char sum[GIMLI_CTR_TAG_LEN],
+                          const unsigned char *c, size_t len, uint64_t block);
+
+/* Compute the tag from the MAC sum of all clen bytes of ciphertext. */
+void gimli_ctr_mac_final(const gimli_ctr_state *s,
+                         unsigned char t[GIMLI_CTR_TAG_LEN],
+                         const unsigned char sum[GIMLI_CTR_TAG_LEN],
+                         const unsigned char *ad, size_t adlen, uint64_t clen);
+
+void gimli_ctr_encrypt(unsigned char *c, unsigned char t[GIMLI_CTR_TAG_LEN],
+                       const unsigned char *m, size_t len,
+                       const unsigned char *ad, size_t adlen,
+                       const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                       const unsigned char k[GIMLI_CTR_KEY_LEN]);
+
+/* If the tag does not match, m is cleared and false is returned. */
+bool gimli_ctr_decrypt(unsigned char *m, const unsigned char *c, size_t len,
+                       const unsigned char t[GIMLI_CTR_TAG_LEN],
+                       const unsigned char *ad, size_t adlen,
+                       const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                       const unsigned char k[GIMLI_CTR_KEY_LEN]);
+
+#endif /* LITHIUM_GIMLI_CTR_H */
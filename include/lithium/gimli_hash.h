@@ -7,7 +7,9 @@
  */
 
 #include <lithium/gimli_state.h>
+#include <lithium/iovec.h>
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /* cffi:begin */
@@ -20,11 +22,80 @@ void gimli_hash_init(gimli_hash_state *g);
 
 void gimli_hash_update(gimli_hash_state *g, const unsigned char *m, size_t len);
 
+/*
+ * Absorb nwords 32-bit words. This is the same as calling gimli_hash_update
+ * with the words stored in little-endian order, but whole words are absorbed
+ * directly into the state, which avoids per-byte work on targets where bytes
+ * are not addressable, such as those with CHAR_BIT == 16.
+ */
+void gimli_hash_update_words(gimli_hash_state *g, const uint32_t *w,
+                             size_t nwords);
+
+/*
+ * Absorb the n fragments of iov in order. This is the same as calling
+ * gimli_hash_update on each fragment, but a block that spans fragments is
+ * gathered and absorbed as a whole block.
+ */
+void gimli_hash_update_iov(gimli_hash_state *g, const lith_iovec *iov,
+                           size_t n);
+
 void gimli_hash_final(gimli_hash_state *g, unsigned char *h, size_t len);
 
 void gimli_hash(unsigned char *h, size_t hlen, const unsigned char *m,
                 size_t mlen);
 
+/*
+ * Hash the input absorbed by prefix followed by m, leaving prefix unchanged.
+ * To hash many messages that start with the same bytes, absorb them once with
+ * gimli_hash_init and gimli_hash_update, and then hash each message from that
+ * state, so the permutations of the prefix are not repeated for each message.
+ */
+void gimli_hash_from(unsigned char *h, size_t hlen,
+                     const gimli_hash_state *prefix, const unsigned char *m,
+                     size_t mlen);
+
+/*
+ * Extendable output. gimli_xof_init finishes absorbing the input given to
+ * gimli_hash_update, and each call to gimli_xof_squeeze then writes the next
+ * len bytes of output. The output stream is the same as the output of
+ * gimli_hash_final, so squeezing n bytes in total gives the same bytes as
+ * gimli_hash_final with length n.
+ */
+void gimli_xof_init(gimli_hash_state *g);
+
+void gimli_xof_squeeze(gimli_hash_state *g, unsigned char *out, size_t len);
+
+#define GIMLI_HASH_EXPORT_LEN 60
+
+/*
+ * Export the state of a hash in progress, so that it can be resumed later,
+ * e.g., after a reboot, with gimli_hash_import. The layout is versioned, the
+ * same on every platform, and includes a check value that detects corruption.
+ * It is not authenticated, so store it where it can't be modified by an
+ * attacker; a modified export that passes the checks resumes a different hash,
+ * but is never unsafe to import. The export does not include the number of
+ * bytes hashed, so store that alongside it. Only a state that is absorbing
+ * input can be exported; the export of an XOF after gimli_xof_init is
+ * rejected by gimli_hash_import.
+ */
+void gimli_hash_export(const gimli_hash_state *g,
+                       unsigned char out[GIMLI_HASH_EXPORT_LEN]);
+
+/* Returns false, leaving g unchanged, if the input is not a valid export. */
+bool gimli_hash_import(gimli_hash_state *g,
+                       const unsigned char in[GIMLI_HASH_EXPORT_LEN]);
+
+/*
+ * Hash n independent messages, writing out_len bytes of the hash of msgs[i],
+ * which is lens[i] bytes long, to outs[i]. The results are the same as calling
+ * gimli_hash on each message, but the messages share the lanes of the
+ * multi-state permutation when vector extensions are available. Without them,
+ * the messages are hashed in turn, which is no faster than calling gimli_hash.
+ */
+void gimli_hash_many(unsigned char *const outs[], size_t out_len,
+                     const unsigned char *const msgs[], const size_t lens[],
+                     size_t n);
+
 /* cffi:end */
 
 #endif /* LITHIUM_GIMLI_HASH_H */
@@ -0,0 +1,168 @@
+#ifndef LITHIUM_GIMLI_HASH_HPP
+#define LITHIUM_GIMLI_HASH_HPP
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * constexpr versions of the Gimli permutation and Gimli-Hash for C++17, so
+ * that digests of constants can be computed at compile time, e.g.,
+ *
+ *     constexpr auto tag = lith::gimli_hash("my-protocol v1");
+ *
+ * The output is the same as gimli_hash from <lithium/gimli_hash.h>. These
+ * process a byte at a time with no vectorization, so use the C library for
+ * input that is only known at run time.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace lith
+{
+
+constexpr std::size_t gimli_words = 12;
+constexpr std::size_t gimli_hash_default_len = 32;
+
+using gimli_words_array = std::array<std::uint32_t, gimli_words>;
+
+namespace detail
+{
+
+constexpr std::uint32_t rol(std::uint32_t x, unsigned n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+constexpr void swap(std::uint32_t &a, std::uint32_t &b)
+{
+    const std::uint32_t tmp = a;
+    a = b;
+    b = tmp;
+}
+
+} // namespace detail
+
+constexpr void gimli(gimli_words_array &state)
+{
+    for (std::uint32_t round = 24; round > 0; --round)
+    {
+        for (std::size_t column = 0; column < 4; ++column)
+        {
+            const std::uint32_t x = detail::rol(state[column], 24);
+            const std::uint32_t y = detail::rol(state[4 + column], 9);
+            const std::uint32_t z = state[8 + column];
+
+            state[8 + column] = x ^ (z << 1) ^ ((y & z) << 2);
+            state[4 + column] = y ^ x ^ ((x | z) << 1);
+            state[column] = z ^ y ^ ((x & y) << 3);
+        }
+
+        if ((round & 3) == 0)
+        {
+            /* small swap: pattern s...s...s... etc. */
+            detail::swap(state[0], state[1]);
+            detail::swap(state[2], state[3]);
+            /* add constant: pattern c...c...c... etc. */
+            state[0] ^= UINT32_C(0x9E377900) | round;
+        }
+        else if ((round & 3) == 2)
+        {
+            /* big swap: pattern ..S...S...S. etc. */
+            detail::swap(state[0], state[2]);
+            detail::swap(state[1], state[3]);
+        }
+    }
+}
+
+class gimli_hash_state
+{
+public:
+    constexpr gimli_hash_state() : state{}, offset(0)
+    {
+    }
+
+    /* Byte may be char, unsigned char, or std::byte. */
+    template <typename Byte>
+    constexpr void update(const Byte *m, std::size_t len)
+    {
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            absorb_byte(static_cast<unsigned char>(m[i]));
+            advance();
+        }
+    }
+
+    constexpr void update(std::string_view m)
+    {
+        update(m.data(), m.size());
+    }
+
+    template <std::size_t N = gimli_hash_default_len>
+    constexpr std::array<unsigned char, N> final()
+    {
+        std::array<unsigned char, N> h{};
+        absorb_byte(0x01);
+        state[gimli_words - 1] ^= UINT32_C(0x01000000);
+        offset = rate - 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            advance();
+            h[i] = static_cast<unsigned char>(
+                (state[offset / 4] >> ((offset % 4) * 8)) & 0xFFU);
+        }
+        return h;
+    }
+
+private:
+    static constexpr std::size_t rate = 16;
+
+    constexpr void absorb_byte(unsigned char x)
+    {
+        state[offset / 4] ^= static_cast<std::uint32_t>(x) << ((offset % 4) * 8);
+    }
+
+    constexpr void advance()
+    {
+        ++offset;
+        if (offset == rate)
+        {
+            gimli(state);
+            offset = 0;
+        }
+    }
+
+    gimli_words_array state;
+    std::size_t offset;
+};
+
+template <std::size_t N = gimli_hash_default_len, typename Byte>
+constexpr std::array<unsigned char, N> gimli_hash(const Byte *m,
+                                                  std::size_t len)
+{
+    gimli_hash_state g;
+    g.update(m, len);
+    return g.final<N>();
+}
+
+template <std::size_t N = gimli_hash_default_len>
+constexpr std::array<unsigned char, N> gimli_hash(std::string_view m)
+{
+    return gimli_hash<N>(m.data(), m.size());
+}
+
+template <std::size_t N = gimli_hash_default_len, typename Byte,
+          std::size_t L>
+constexpr std::array<unsigned char, N>
+gimli_hash(const std::array<Byte, L> &m)
+{
+    return gimli_hash<N>(m.data(), L);
+}
+
+} // namespace lith
+
+#endif /* LITHIUM_GIMLI_HASH_HPP */
@@ -0,0 +1,50 @@
+#ifndef LITHIUM_GIMLI_SHORT_HASH_H
+#define LITHIUM_GIMLI_SHORT_HASH_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Keyed hashes of short inputs, such as the keys of hash tables and indexes,
+ * with 64-bit or 128-bit outputs. The key is placed in the capacity of the
+ * initial state, so there is no setup cost per key, and an input of len bytes
+ * takes len / 16 + 1 permutations. The input is absorbed in a single call
+ * without the incremental sponge, which is the main cost for inputs of up to
+ * 48 bytes. Longer inputs are also accepted.
+ *
+ * The 64-bit output is suitable for hash tables, where an attacker who does
+ * not know the key can't cause collisions. Use the 128-bit output where
+ * collisions must not occur by chance either, such as in deduplication.
+ */
+
+#define GIMLI_SHORT_HASH_KEY_LEN 16
+#define GIMLI_SHORT_HASH_128_LEN 16
+
+uint64_t gimli_short_hash64(const unsigned char *m, size_t len,
+                            const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN]);
+
+void gimli_short_hash128(unsigned char h[GIMLI_SHORT_HASH_128_LEN],
+                         const unsigned char *m, size_t len,
+                         const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN]);
+
+/*
+ * Hash n inputs with the same key, where msgs[i] is lens[i] bytes long. The
+ * results are the same as hashing each input in turn, but the inputs share
+ * the lanes of the multi-state permutation when vector extensions are
+ * available.
+ */
+void gimli_short_hash64_many(uint64_t h[], const unsigned char *const msgs[],
+                             const size_t lens[], size_t n,
+                             const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN]);
+
+void gimli_short_hash128_many(
+    unsigned char *const outs[], const unsigned char *const msgs[],
+    const size_t lens[], size_t n,
+    const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN]);
+
+#endif /* LITHIUM_GIMLI_SHORT_HASH_H */
@@ -0,0 +1,81 @@
+#ifndef LITHIUM_GIMLI_STREAM_H
+#define LITHIUM_GIMLI_STREAM_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Chunked authenticated encryption, using the STREAM construction with Gimli
+ * AEAD. The plaintext is split into chunks, and each chunk is encrypted with
+ * its own tag and a nonce made of a per-stream prefix, the index of the chunk
+ * as a 32-bit little-endian integer, and a byte that is 1 for the last chunk
+ * and 0 otherwise. A decryptor can release the plaintext of each chunk as
+ * soon as its tag is checked, using memory for one chunk, and reordering,
+ * dropping, or truncating chunks is detected.
+ *
+ * Use a fixed chunk length for every chunk but the last, which may be
+ * shorter, and store each chunk followed by its tag. Chunk i then starts at
+ * offset i * (chunk length + GIMLI_STREAM_TAG_LEN) and can be decrypted on
+ * its own with gimli_stream_decrypt_chunk.
+ *
+ * The prefix must be unique for each stream encrypted with a key, e.g.,
+ * random.
+ */
+
+#define GIMLI_STREAM_PREFIX_LEN 11
+#define GIMLI_STREAM_KEY_LEN GIMLI_AEAD_KEY_LEN
+#define GIMLI_STREAM_TAG_LEN GIMLI_AEAD_TAG_DEFAULT_LEN
+
+typedef struct
+{
+    uint32_t index;
+    unsigned char key[GIMLI_STREAM_KEY_LEN];
+    unsigned char prefix[GIMLI_STREAM_PREFIX_LEN];
+    bool done;
+} gimli_stream_state;
+
+void gimli_stream_init(gimli_stream_state *s,
+                       const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+                       const unsigned char key[GIMLI_STREAM_KEY_LEN]);
+
+/*
+ * Encrypt the next chunk, which is the last if last is true. Returns false,
+ * writing nothing, if the last chunk has already been processed or there are
+ * no more chunk indexes.
+ */
+bool gimli_stream_encrypt_next(gimli_stream_state *s, unsigned char *c,
+                               unsigned char t[GIMLI_STREAM_TAG_LEN],
+                               const unsigned char *m, size_t len, bool last);
+
+/*
+ * Decrypt the next chunk. Returns false, clearing m, if the chunk is not
+ * authentic, or if it is not the expected next chunk, e.g., because the last
+ * flag does not match. After a failure, the stream must not be continued.
+ */
+bool gimli_stream_decrypt_next(gimli_stream_state *s, unsigned char *m,
+                               const unsigned char *c, size_t len,
+                               const unsigned char t[GIMLI_STREAM_TAG_LEN],
+                               bool last);
+
+/* Encrypt or decrypt chunk index of a stream on its own. */
+void gimli_stream_encrypt_chunk(
+    unsigned char *c, unsigned char t[GIMLI_STREAM_TAG_LEN],
+    const unsigned char *m, size_t len, uint32_t index, bool last,
+    const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+    const unsigned char key[GIMLI_STREAM_KEY_LEN]);
+
+bool gimli_stream_decrypt_chunk(
+    unsigned char *m, const unsigned char *c, size_t len,
+    const unsigned char t[GIMLI_STREAM_TAG_LEN], uint32_t index, bool last,
+    const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+    const unsigned char key[GIMLI_STREAM_KEY_LEN]);
+
+#endif /* LITHIUM_GIMLI_STREAM_H */
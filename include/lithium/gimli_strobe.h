@@ -0,0 +1,84 @@
+#ifndef LITHIUM_GIMLI_STROBE_H
+#define LITHIUM_GIMLI_STROBE_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_state.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * A protocol transcript on a single Gimli duplex, with the operations and
+ * framing of the STROBE protocol framework. It is not compatible with STROBE
+ * itself, which uses Keccak-f[1600].
+ *
+ * Every operation is absorbed into the transcript, so each output depends on
+ * the protocol name and on everything sent, received, or added before it.
+ * Each operation starts with two bytes of framing, and the state is permuted
+ * when its rate is full, and at the start of the operations that use the
+ * state as a key (gimli_strobe_key, the encryption operations, the MACs, and
+ * gimli_strobe_prf), so that their output depends on everything before them.
+ * Associated data is absorbed without any extra permutations.
+ *
+ * The two parties of a protocol run the same operations, with each send
+ * matched by a receive on the other side. The party that sends first is the
+ * initiator, which is recorded so that both transcripts stay the same.
+ *
+ * The operations that take a more flag can be continued by a further call to
+ * the same operation with more set to true, so that e.g., a message can be
+ * encrypted in pieces. The result is the same as a single call with all of
+ * the data.
+ */
+
+#define GIMLI_STROBE_MAC_LEN 16U
+
+typedef struct
+{
+    gimli_state g;
+    unsigned char pos_begin;
+    unsigned char flags;
+    unsigned char initiator;
+    unsigned char pad;
+} gimli_strobe_state;
+
+/* Start a transcript for the protocol named by len bytes of proto. */
+void gimli_strobe_init(gimli_strobe_state *s, const unsigned char *proto,
+                       size_t len);
+
+/* Add associated data that both parties know. */
+void gimli_strobe_ad(gimli_strobe_state *s, const unsigned char *ad,
+                     size_t len, bool more);
+
+/* Key the transcript. The key replaces part of the state. */
+void gimli_strobe_key(gimli_strobe_state *s, const unsigned char *key,
+                      size_t len);
+
+void gimli_strobe_send_enc(gimli_strobe_state *s, unsigned char *c,
+                           const unsigned char *m, size_t len, bool more);
+
+/*
+ * The plaintext is not authentic until a MAC that follows it has been
+ * received.
+ */
+void gimli_strobe_recv_enc(gimli_strobe_state *s, unsigned char *m,
+                           const unsigned char *c, size_t len, bool more);
+
+void gimli_strobe_send_mac(gimli_strobe_state *s, unsigned char *t,
+                           size_t len);
+
+/*
+ * Returns false if the MAC does not match, after which the transcript must
+ * not be used.
+ */
+bool gimli_strobe_recv_mac(gimli_strobe_state *s, const unsigned char *t,
+                           size_t len);
+
+/* Output len pseudorandom bytes, e.g., to derive session keys. */
+void gimli_strobe_prf(gimli_strobe_state *s, unsigned char *out, size_t len,
+                      bool more);
+
+#endif /* LITHIUM_GIMLI_STROBE_H */
@@ -0,0 +1,74 @@
+#ifndef LITHIUM_GIMLI_TREE_H
+#define LITHIUM_GIMLI_TREE_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_state.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Tree hashing with Gimli-Hash. The input is split into leaves of
+ * GIMLI_TREE_LEAF_LEN bytes, and the last leaf may be shorter. An empty input
+ * is a single empty leaf. The leaves and parent nodes are hashed with
+ * domain-separated Gimli-Hash, and the nodes form the same binary tree as
+ * RFC 6962: the left subtree of a tree of n > 1 leaves holds the largest power
+ * of two of the leaves that is less than n.
+ *
+ * Whole leaves are hashed together in the lanes of the multi-state
+ * permutation. To use multiple threads, hash aligned runs of a power of two
+ * leaves with gimli_tree_hash on each thread, and add the results in order
+ * with gimli_tree_update_subtree.
+ */
+
+#define GIMLI_TREE_LEAF_LEN 4096U
+#define GIMLI_TREE_HASH_LEN 32U
+
+/* The stack holds one node per set bit of the leaf count. */
+#define GIMLI_TREE_MAX_DEPTH 64U
+
+typedef struct
+{
+    uint64_t leaves;
+    size_t leaf_len;
+    gimli_state leaf;
+    unsigned depth;
+    unsigned char stack[GIMLI_TREE_MAX_DEPTH][GIMLI_TREE_HASH_LEN];
+} gimli_tree_state;
+
+void gimli_tree_init(gimli_tree_state *g);
+
+void gimli_tree_update(gimli_tree_state *g, const unsigned char *m,
+                       size_t len);
+
+/*
+ * Add the root of a subtree of leaves leaves, which must be a power of two, as
+ * computed by gimli_tree_hash. The input so far must be a multiple of
+ * leaves * GIMLI_TREE_LEAF_LEN bytes. Returns false, leaving g unchanged, if
+ * leaves is not a power of two or the input so far is not such a multiple.
+ */
+bool gimli_tree_update_subtree(gimli_tree_state *g,
+                               const unsigned char root[GIMLI_TREE_HASH_LEN],
+                               uint64_t leaves);
+
+void gimli_tree_final(gimli_tree_state *g,
+                      unsigned char root[GIMLI_TREE_HASH_LEN]);
+
+void gimli_tree_hash(unsigned char root[GIMLI_TREE_HASH_LEN],
+                     const unsigned char *m, size_t len);
+
+/* Hash a single leaf of at most GIMLI_TREE_LEAF_LEN bytes. */
+void gimli_tree_leaf(unsigned char h[GIMLI_TREE_HASH_LEN],
+                     const unsigned char *m, size_t len);
+
+/* Hash a parent node from the hashes of its children. */
+void gimli_tree_parent(unsigned char h[GIMLI_TREE_HASH_LEN],
+                       const unsigned char left[GIMLI_TREE_HASH_LEN],
+                       const unsigned char right[GIMLI_TREE_HASH_LEN]);
+
+#endif /* LITHIUM_GIMLI_TREE_H */
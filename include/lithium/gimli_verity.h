@@ -0,0 +1,75 @@
+#ifndef LITHIUM_GIMLI_VERITY_H
+#define LITHIUM_GIMLI_VERITY_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_tree.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Block-authenticated images. An image is split into blocks of
+ * GIMLI_TREE_LEAF_LEN bytes, and the hashes of all of the nodes of its
+ * gimli_tree_hash tree are stored alongside it. The root is the same as
+ * gimli_tree_hash of the image, so it can be signed with
+ * lith_sign_create_tree_root.
+ *
+ * A reader checks the signature of the root once, and then verifies each
+ * block as it is read, using the stored nodes on the path from the block to
+ * the root. The stored nodes are not trusted: a node is only used once it has
+ * been verified against the root, and verified nodes can be remembered in a
+ * bitmap, so later blocks only need to be checked up to the first node that
+ * is already known to be good.
+ *
+ * The nodes are stored level by level, starting with the block hashes. Each
+ * level has half as many nodes as the level below it, rounded up, and the
+ * last node of a level with an odd number of nodes is repeated on the next
+ * level.
+ */
+
+/* The number of blocks in an image of len bytes. */
+uint64_t gimli_verity_blocks(uint64_t len);
+
+/* The number of nodes stored for an image of blocks blocks. */
+uint64_t gimli_verity_nodes(uint64_t blocks);
+
+/*
+ * Hash an image. nodes must have room for gimli_verity_nodes(blocks) *
+ * GIMLI_TREE_HASH_LEN bytes.
+ */
+void gimli_verity_build(unsigned char *nodes,
+                        unsigned char root[GIMLI_TREE_HASH_LEN],
+                        const unsigned char *image, size_t len);
+
+typedef struct
+{
+    unsigned char root[GIMLI_TREE_HASH_LEN];
+    const unsigned char *nodes;
+    uint64_t blocks;
+    unsigned char *verified;
+} gimli_verity_state;
+
+/*
+ * root must already be trusted, e.g., by lith_sign_verify_tree_root. verified
+ * is a bitmap of (gimli_verity_nodes(blocks) + 7) / 8 bytes, which must be
+ * zeroed before the first use, or NULL to verify every block all the way to
+ * the root.
+ */
+void gimli_verity_init(gimli_verity_state *v,
+                       const unsigned char root[GIMLI_TREE_HASH_LEN],
+                       const unsigned char *nodes, uint64_t blocks,
+                       unsigned char *verified);
+
+/*
+ * Verify block index, of len bytes. Every block but the last must be
+ * GIMLI_TREE_LEAF_LEN bytes.
+ */
+bool gimli_verity_verify_block(gimli_verity_state *v, uint64_t index,
+                               const unsigned char *block, size_t len);
+
+#endif /* LITHIUM_GIMLI_VERITY_H */
@@ -0,0 +1,26 @@
+#ifndef LITHIUM_IOVEC_H
+#define LITHIUM_IOVEC_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stddef.h>
+
+/* cffi:begin */
+
+/*
+ * A fragment of a scatter/gather buffer, for the _iov variants of the update
+ * functions. It has the same members, in the same order, as POSIX struct
+ * iovec. Fragments may be empty.
+ */
+typedef struct
+{
+    void *base;
+    size_t len;
+} lith_iovec;
+
+/* cffi:end */
+
+#endif /* LITHIUM_IOVEC_H */
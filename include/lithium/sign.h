@@ -7,6 +7,7 @@
  */
 
 #include <lithium/gimli_hash.h>
+#include <lithium/gimli_tree.h>
 
 #include <stdbool.h>
 
@@ -27,6 +28,40 @@ void lith_sign_init(lith_sign_state *state);
 void lith_sign_update(lith_sign_state *state, const unsigned char *msg,
                       size_t len);
 
+/*
+ * Add nwords 32-bit words to the message, as if they were passed to
+ * lith_sign_update in little-endian order.
+ */
+void lith_sign_update_words(lith_sign_state *state, const uint32_t *msg,
+                            size_t nwords);
+
+/* Add the n fragments of iov to the message, like gimli_hash_update_iov. */
+void lith_sign_update_iov(lith_sign_state *state, const lith_iovec *iov,
+                          size_t n);
+
+/*
+ * Decrypt len bytes of c with the Gimli AEAD state aead into msg, like
+ * gimli_aead_decrypt_update, and add the plaintext to the message in the same
+ * pass, for images that are encrypted and signed over the plaintext. See
+ * gimli_aead_decrypt_update_hash.
+ */
+void lith_sign_decrypt_update(lith_sign_state *state, gimli_state *aead,
+                              unsigned char *msg, const unsigned char *c,
+                              size_t len);
+
+#define LITH_SIGN_EXPORT_LEN 60
+
+/*
+ * Export and import a lith_sign_state, like gimli_hash_export and
+ * gimli_hash_import. A lith_sign export can only be imported as a lith_sign
+ * state, and a gimli_hash export only as a gimli_hash state.
+ */
+void lith_sign_export(const lith_sign_state *state,
+                      unsigned char out[LITH_SIGN_EXPORT_LEN]);
+
+bool lith_sign_import(lith_sign_state *state,
+                      const unsigned char in[LITH_SIGN_EXPORT_LEN]);
+
 void lith_sign_final_create(lith_sign_state *state,
                             unsigned char sig[LITH_SIGN_LEN],
                             const unsigned char
@@ -62,4 +97,20 @@ bool lith_sign_verify(const unsigned char sig[LITH_SIGN_LEN],
 
 /* cffi:end */
 
+/*
+ * Sign or verify the root of a tree hash from <lithium/gimli_tree.h> rather
+ * than the message itself, so that large inputs can be hashed on multiple
+ * threads. The prehash of the root is domain-separated, so a tree root
+ * signature is never valid for a message that happens to equal the root.
+ */
+void lith_sign_create_tree_root(unsigned char sig[LITH_SIGN_LEN],
+                                const unsigned char root[GIMLI_TREE_HASH_LEN],
+                                const unsigned char
+                                    secret_key[LITH_SIGN_SECRET_KEY_LEN]);
+
+bool lith_sign_verify_tree_root(const unsigned char sig[LITH_SIGN_LEN],
+                                const unsigned char root[GIMLI_TREE_HASH_LEN],
+                                const unsigned char
+                                    public_key[LITH_SIGN_PUBLIC_KEY_LEN]);
+
 #endif /* LITHIUM_SIGN_H */
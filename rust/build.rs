@@ -4,11 +4,23 @@
 use std::{env, path::PathBuf};
 
 static SOURCES: &[&str] = &[
+    "backend.c",
     "fe.c",
     "gimli.c",
+    "gimli_x.c",
     "gimli_aead.c",
+    "gimli_aead_many.c",
+    "gimli_checkpoint.c",
+    "gimli_chunker.c",
+    "gimli_ctr.c",
     "gimli_common.c",
     "gimli_hash.c",
+    "gimli_hash_many.c",
+    "gimli_short_hash.c",
+    "gimli_stream.c",
+    "gimli_strobe.c",
+    "gimli_tree.c",
+    "gimli_verity.c",
     "memzero.c",
     "random.c",
     "sign.c",
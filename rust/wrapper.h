@@ -3,8 +3,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <lithium/backend.h>
 #include <lithium/gimli.h>
 #include <lithium/gimli_aead.h>
+#include <lithium/gimli_checkpoint.h>
+#include <lithium/gimli_chunker.h>
+#include <lithium/gimli_ctr.h>
 #include <lithium/gimli_hash.h>
+#include <lithium/gimli_short_hash.h>
+#include <lithium/gimli_stream.h>
+#include <lithium/gimli_strobe.h>
+#include <lithium/gimli_tree.h>
+#include <lithium/gimli_verity.h>
 #include <lithium/sign.h>
 #include <lithium/x25519.h>
@@ -0,0 +1,221 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/backend.h>
+
+#include <lithium/gimli.h>
+
+#include "gimli_common.h"
+#include "opt.h"
+
+#include <stddef.h>
+
+#if (LITH_DISPATCH)
+
+#if !(defined(__GNUC__) || defined(__clang__)) ||                              \
+    !(defined(__x86_64__) || defined(__i386__))
+#error "LITH_DISPATCH requires gcc or clang on x86"
+#endif
+
+#define DECLARE_VARIANT(variant)                                               \
+    void gimli_##variant(uint32_t state[GIMLI_WORDS]);                         \
+    void gimli_x2_##variant(uint32_t state[GIMLI_WORDS * 2]);                  \
+    void gimli_x4_##variant(uint32_t state[GIMLI_WORDS * 4]);                  \
+    void gimli_x8_##variant(uint32_t state[GIMLI_WORDS * 8]);                  \
+    void gimli_x16_##variant(uint32_t state[GIMLI_WORDS * 16]);                \
+    void gimli_absorb_blocks_##variant(uint32_t state[GIMLI_WORDS],            \
+                                       const unsigned char *m, size_t blocks); \
+    void gimli_encrypt_blocks_##variant(uint32_t state[GIMLI_WORDS],           \
+                                        unsigned char *c,                      \
+                                        const unsigned char *m,                \
+                                        size_t blocks);                        \
+    void gimli_decrypt_blocks_##variant(uint32_t state[GIMLI_WORDS],           \
+                                        unsigned char *m,                      \
+                                        const unsigned char *c,                \
+                                        size_t blocks);                        \
+    void gimli_decrypt_absorb_blocks_##variant(                                \
+        uint32_t state[GIMLI_WORDS], uint32_t hash[GIMLI_WORDS],               \
+        unsigned char *m, const unsigned char *c, size_t blocks);              \
+    void gimli_squeeze_blocks_##variant(uint32_t state[GIMLI_WORDS],           \
+                                        unsigned char *h, size_t blocks)
+
+#define VARIANT(variant)                                                       \
+    {                                                                          \
+        #variant, gimli_##variant, gimli_x2_##variant, gimli_x4_##variant,     \
+            gimli_x8_##variant, gimli_x16_##variant,                           \
+            gimli_absorb_blocks_##variant, gimli_encrypt_blocks_##variant,     \
+            gimli_decrypt_blocks_##variant,                                    \
+            gimli_decrypt_absorb_blocks_##variant,                             \
+            gimli_squeeze_blocks_##variant                                     \
+    }
+
+DECLARE_VARIANT(scalar);
+DECLARE_VARIANT(sse2);
+DECLARE_VARIANT(ssse3);
+DECLARE_VARIANT(avx2);
+DECLARE_VARIANT(avx512);
+
+struct backend
+{
+    const char *name;
+    void (*gimli)(uint32_t *state);
+    void (*gimli_x2)(uint32_t *state);
+    void (*gimli_x4)(uint32_t *state);
+    void (*gimli_x8)(uint32_t *state);
+    void (*gimli_x16)(uint32_t *state);
+    void (*absorb_blocks)(uint32_t *state, const unsigned char *m,
+                          size_t blocks);
+    void (*encrypt_blocks)(uint32_t *state, unsigned char *c,
+                           const unsigned char *m, size_t blocks);
+    void (*decrypt_blocks)(uint32_t *state, unsigned char *m,
+                           const unsigned char *c, size_t blocks);
+    void (*decrypt_absorb_blocks)(uint32_t *state, uint32_t *hash,
+                                  unsigned char *m, const unsigned char *c,
+                                  size_t blocks);
+    void (*squeeze_blocks)(uint32_t *state, unsigned char *h, size_t blocks);
+};
+
+static const struct backend backends[] = {
+    VARIANT(scalar), VARIANT(sse2), VARIANT(ssse3),
+    VARIANT(avx2),   VARIANT(avx512),
+};
+
+enum
+{
+    SCALAR,
+    SSE2,
+    SSSE3,
+    AVX2,
+    AVX512
+};
+
+static const struct backend *active = NULL;
+
+static const struct backend *select_backend(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vl"))
+    {
+        return &backends[AVX512];
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return &backends[AVX2];
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return &backends[SSSE3];
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return &backends[SSE2];
+    }
+    return &backends[SCALAR];
+}
+
+/*
+ * Select the backend before main runs so that the active backend never
+ * changes after threads may have started.
+ */
+__attribute__((constructor)) static void init_backend(void)
+{
+    active = select_backend();
+}
+
+/*
+ * Other constructors may use the library before init_backend runs, so select
+ * the backend for each such call without storing it. active is only written
+ * by init_backend, before any threads can start, so it is never written while
+ * another thread reads it.
+ */
+static const struct backend *backend(void)
+{
+    const struct backend *const b = active;
+    return (b != NULL) ? b : select_backend();
+}
+
+void gimli(uint32_t state[GIMLI_WORDS])
+{
+    backend()->gimli(state);
+}
+
+void gimli_x2(uint32_t state[GIMLI_WORDS * 2])
+{
+    backend()->gimli_x2(state);
+}
+
+void gimli_x4(uint32_t state[GIMLI_WORDS * 4])
+{
+    backend()->gimli_x4(state);
+}
+
+void gimli_x8(uint32_t state[GIMLI_WORDS * 8])
+{
+    backend()->gimli_x8(state);
+}
+
+void gimli_x16(uint32_t state[GIMLI_WORDS * 16])
+{
+    backend()->gimli_x16(state);
+}
+
+void gimli_absorb_blocks(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                         size_t blocks)
+{
+    backend()->absorb_blocks(state, m, blocks);
+}
+
+void gimli_encrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *c,
+                          const unsigned char *m, size_t blocks)
+{
+    backend()->encrypt_blocks(state, c, m, blocks);
+}
+
+void gimli_decrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *m,
+                          const unsigned char *c, size_t blocks)
+{
+    backend()->decrypt_blocks(state, m, c, blocks);
+}
+
+void gimli_decrypt_absorb_blocks(uint32_t state[GIMLI_WORDS],
+                                 uint32_t hash[GIMLI_WORDS], unsigned char *m,
+                                 const unsigned char *c, size_t blocks)
+{
+    backend()->decrypt_absorb_blocks(state, hash, m, c, blocks);
+}
+
+void gimli_squeeze_blocks(uint32_t state[GIMLI_WORDS], unsigned char *h,
+                          size_t blocks)
+{
+    backend()->squeeze_blocks(state, h, blocks);
+}
+
+const char *lith_backend(void)
+{
+    return backend()->name;
+}
+
+#else /* !LITH_DISPATCH */
+
+const char *lith_backend(void)
+{
+#if !(LITH_VECTORIZE)
+    return "scalar";
+#elif defined(__AVX512VL__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSSE3__)
+    return "ssse3";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "altivec";
+#endif
+}
+
+#endif /* LITH_DISPATCH */
@@ -0,0 +1,40 @@
+#ifndef LITHIUM_DISPATCH_H
+#define LITHIUM_DISPATCH_H
+
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * With LITH_DISPATCH, the permutation sources are compiled once per variant
+ * with LITH_DISPATCH_VARIANT set to the variant's name and the matching
+ * target flags. Each variant's entry points get the variant name as a suffix,
+ * e.g., gimli_avx2, and backend.c defines the unsuffixed entry points, which
+ * forward to the variant selected for the CPU at startup. This includes the
+ * fused sponge kernels from gimli_common.h.
+ */
+#if defined(LITH_DISPATCH_VARIANT)
+
+#define LITH_VARIANT_NAME_(name, variant) name##_##variant
+#define LITH_VARIANT_NAME(name, variant) LITH_VARIANT_NAME_(name, variant)
+
+#define gimli LITH_VARIANT_NAME(gimli, LITH_DISPATCH_VARIANT)
+#define gimli_x2 LITH_VARIANT_NAME(gimli_x2, LITH_DISPATCH_VARIANT)
+#define gimli_x4 LITH_VARIANT_NAME(gimli_x4, LITH_DISPATCH_VARIANT)
+#define gimli_x8 LITH_VARIANT_NAME(gimli_x8, LITH_DISPATCH_VARIANT)
+#define gimli_x16 LITH_VARIANT_NAME(gimli_x16, LITH_DISPATCH_VARIANT)
+#define gimli_absorb_blocks                                                    \
+    LITH_VARIANT_NAME(gimli_absorb_blocks, LITH_DISPATCH_VARIANT)
+#define gimli_encrypt_blocks                                                   \
+    LITH_VARIANT_NAME(gimli_encrypt_blocks, LITH_DISPATCH_VARIANT)
+#define gimli_decrypt_blocks                                                   \
+    LITH_VARIANT_NAME(gimli_decrypt_blocks, LITH_DISPATCH_VARIANT)
+#define gimli_decrypt_absorb_blocks                                            \
+    LITH_VARIANT_NAME(gimli_decrypt_absorb_blocks, LITH_DISPATCH_VARIANT)
+#define gimli_squeeze_blocks                                                   \
+    LITH_VARIANT_NAME(gimli_squeeze_blocks, LITH_DISPATCH_VARIANT)
+
+#endif /* defined(LITH_DISPATCH_VARIANT) */
+
+#endif /* LITHIUM_DISPATCH_H */
@@ -3,8 +3,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+/* Must come first so that the entry points are renamed for dispatch. */
+#include "dispatch.h"
+
 #include <lithium/gimli.h>
 
+#include "gimli_common.h"
 #include "opt.h"
 
 static uint32_t coeff(int round)
@@ -42,38 +46,248 @@ static uint32x4_t rol24(uint32x4_t x)
 #endif
 }
 
+#define SP_BOX(x, y, z)                                                        \
+    do                                                                         \
+    {                                                                          \
+        uint32x4_t newy, newz;                                                 \
+        x = rol24(x);                                                          \
+        y = rol(y, 9);                                                         \
+        newz = x ^ (z << 1) ^ ((y & z) << 2);                                  \
+        newy = y ^ x ^ ((x | z) << 1);                                         \
+        x = z ^ y ^ ((x & y) << 3);                                            \
+        y = newy;                                                              \
+        z = newz;                                                              \
+    } while (0)
+
+/*
+ * Every group of four rounds has the same pattern of swaps, so unrolling by
+ * four removes the round & 3 switch. This is a macro rather than a function so
+ * that the block kernels below keep x, y, and z in registers across
+ * permutations.
+ */
+#define PERMUTE(x, y, z)                                                       \
+    do                                                                         \
+    {                                                                          \
+        int round;                                                             \
+        for (round = 24; round > 0; round -= 4)                                \
+        {                                                                      \
+            SP_BOX(x, y, z);                                                   \
+            /* small swap: pattern s...s...s... etc. */                        \
+            x = shuffle(x, 1, 0, 3, 2);                                        \
+            /* add constant: pattern c...c...c... etc. */                      \
+            x ^= (uint32x4_t){coeff(round)};                                   \
+            SP_BOX(x, y, z);                                                   \
+            SP_BOX(x, y, z);                                                   \
+            /* big swap: pattern ..S...S...S. etc. */                          \
+            x = shuffle(x, 2, 3, 0, 1);                                        \
+            SP_BOX(x, y, z);                                                   \
+        }                                                                      \
+    } while (0)
+
 void gimli(uint32_t state[GIMLI_WORDS])
 {
     uint32x4_t *s = (uint32x4_t *)state;
     uint32x4_t x = s[0];
     uint32x4_t y = s[1];
     uint32x4_t z = s[2];
-    int round;
-    for (round = 24; round > 0; --round)
+    PERMUTE(x, y, z);
+    s[0] = x;
+    s[1] = y;
+    s[2] = z;
+}
+
+#if (LITH_SPONGE_VECTORS)
+/* The sponge is little-endian, so on big-endian targets swap each word. */
+static uint32x4_t block_order(uint32x4_t x)
+{
+#if (LITH_BIG_ENDIAN)
+    uint8x16_t xb = (uint8x16_t)x;
+    xb = shuffle(xb, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    return (uint32x4_t)xb;
+#else
+    return x;
+#endif
+}
+#endif
+
+static uint32x4_t load_block(const unsigned char *p)
+{
+#if (LITH_SPONGE_VECTORS)
+    return block_order((uint32x4_t)(*(const block *)p));
+#else
+    const uint32x4_t x = {gimli_load(p), gimli_load(&p[4]), gimli_load(&p[8]),
+                          gimli_load(&p[12])};
+    return x;
+#endif
+}
+
+static void store_block(unsigned char *p, uint32x4_t x)
+{
+#if (LITH_SPONGE_VECTORS)
+    *(block *)p = (block)block_order(x);
+#else
+    gimli_store(p, x[0]);
+    gimli_store(&p[4], x[1]);
+    gimli_store(&p[8], x[2]);
+    gimli_store(&p[12], x[3]);
+#endif
+}
+
+void gimli_absorb_blocks(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                         size_t blocks)
+{
+    uint32x4_t *s = (uint32x4_t *)state;
+    uint32x4_t x = s[0];
+    uint32x4_t y = s[1];
+    uint32x4_t z = s[2];
+    for (; blocks > 0; --blocks)
     {
-        uint32x4_t newy, newz;
-        x = rol24(x);
-        y = rol(y, 9);
-        newz = x ^ (z << 1) ^ ((y & z) << 2);
-        newy = y ^ x ^ ((x | z) << 1);
-        x = z ^ y ^ ((x & y) << 3);
-        y = newy;
-        z = newz;
-        switch (round & 3)
-        {
-        case 0:
-            /* small swap: pattern s...s...s... etc. */
-            x = shuffle(x, 1, 0, 3, 2);
-            /* add constant: pattern c...c...c... etc. */
-            x ^= (uint32x4_t){coeff(round)};
-            break;
-        case 2:
-            /* big swap: pattern ..S...S...S. etc. */
-            x = shuffle(x, 2, 3, 0, 1);
-            break;
-        default:
-            break;
-        }
+        x ^= load_block(m);
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        PERMUTE(x, y, z);
+        m += GIMLI_RATE;
+    }
+    s[0] = x;
+    s[1] = y;
+    s[2] = z;
+}
+
+void gimli_encrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *c,
+                          const unsigned char *m, size_t blocks)
+{
+    uint32x4_t *s = (uint32x4_t *)state;
+    uint32x4_t x = s[0];
+    uint32x4_t y = s[1];
+    uint32x4_t z = s[2];
+    for (; blocks > 0; --blocks)
+    {
+        x ^= load_block(m);
+        store_block(c, x);
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        PERMUTE(x, y, z);
+        c += GIMLI_RATE;
+        m += GIMLI_RATE;
+    }
+    s[0] = x;
+    s[1] = y;
+    s[2] = z;
+}
+
+void gimli_decrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *m,
+                          const unsigned char *c, size_t blocks)
+{
+    uint32x4_t *s = (uint32x4_t *)state;
+    uint32x4_t x = s[0];
+    uint32x4_t y = s[1];
+    uint32x4_t z = s[2];
+    for (; blocks > 0; --blocks)
+    {
+        /*
+         * We absorb the message data back into the state after outputting it,
+         * which amounts to:
+         * x ^= m;
+         * but we can rewrite as:
+         * x ^= x ^ c;
+         * and again as:
+         * x = x ^ x ^ c;
+         * and finally:
+         * x = c;
+         */
+        const uint32x4_t cb = load_block(c);
+        store_block(m, x ^ cb);
+        x = cb;
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        PERMUTE(x, y, z);
+        m += GIMLI_RATE;
+        c += GIMLI_RATE;
+    }
+    s[0] = x;
+    s[1] = y;
+    s[2] = z;
+}
+
+/*
+ * Two independent permutations, with their rounds interleaved so that each
+ * fills the gaps in the other's dependency chain.
+ */
+#define PERMUTE2(xa, ya, za, xb, yb, zb)                                       \
+    do                                                                         \
+    {                                                                          \
+        int round;                                                             \
+        for (round = 24; round > 0; round -= 4)                                \
+        {                                                                      \
+            SP_BOX(xa, ya, za);                                                \
+            SP_BOX(xb, yb, zb);                                                \
+            xa = shuffle(xa, 1, 0, 3, 2);                                      \
+            xb = shuffle(xb, 1, 0, 3, 2);                                      \
+            xa ^= (uint32x4_t){coeff(round)};                                  \
+            xb ^= (uint32x4_t){coeff(round)};                                  \
+            SP_BOX(xa, ya, za);                                                \
+            SP_BOX(xb, yb, zb);                                                \
+            SP_BOX(xa, ya, za);                                                \
+            SP_BOX(xb, yb, zb);                                                \
+            xa = shuffle(xa, 2, 3, 0, 1);                                      \
+            xb = shuffle(xb, 2, 3, 0, 1);                                      \
+            SP_BOX(xa, ya, za);                                                \
+            SP_BOX(xb, yb, zb);                                                \
+        }                                                                      \
+    } while (0)
+
+void gimli_decrypt_absorb_blocks(uint32_t state[GIMLI_WORDS],
+                                 uint32_t hash[GIMLI_WORDS], unsigned char *m,
+                                 const unsigned char *c, size_t blocks)
+{
+    uint32x4_t *s = (uint32x4_t *)state;
+    uint32x4_t *h = (uint32x4_t *)hash;
+    uint32x4_t xa = s[0];
+    uint32x4_t ya = s[1];
+    uint32x4_t za = s[2];
+    uint32x4_t xb = h[0];
+    uint32x4_t yb = h[1];
+    uint32x4_t zb = h[2];
+    for (; blocks > 0; --blocks)
+    {
+        const uint32x4_t cb = load_block(c);
+        const uint32x4_t mb = xa ^ cb;
+        store_block(m, mb);
+        xa = cb;
+        xb ^= mb;
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        PERMUTE2(xa, ya, za, xb, yb, zb);
+        m += GIMLI_RATE;
+        c += GIMLI_RATE;
+    }
+    s[0] = xa;
+    s[1] = ya;
+    s[2] = za;
+    h[0] = xb;
+    h[1] = yb;
+    h[2] = zb;
+}
+
+void gimli_squeeze_blocks(uint32_t state[GIMLI_WORDS], unsigned char *h,
+                          size_t blocks)
+{
+    uint32x4_t *s = (uint32x4_t *)state;
+    uint32x4_t x = s[0];
+    uint32x4_t y = s[1];
+    uint32x4_t z = s[2];
+    for (; blocks > 0; --blocks)
+    {
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        PERMUTE(x, y, z);
+        store_block(h, x);
+        h += GIMLI_RATE;
     }
     s[0] = x;
     s[1] = y;
@@ -125,4 +339,106 @@ void gimli(uint32_t state[GIMLI_WORDS])
     }
 }
 
+void gimli_absorb_blocks(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                         size_t blocks)
+{
+    for (; blocks > 0; --blocks)
+    {
+        unsigned i;
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            state[i] ^= gimli_load(&m[i * 4]);
+        }
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(state);
+        m += GIMLI_RATE;
+    }
+}
+
+void gimli_encrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *c,
+                          const unsigned char *m, size_t blocks)
+{
+    for (; blocks > 0; --blocks)
+    {
+        unsigned i;
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            state[i] ^= gimli_load(&m[i * 4]);
+            gimli_store(&c[i * 4], state[i]);
+        }
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(state);
+        c += GIMLI_RATE;
+        m += GIMLI_RATE;
+    }
+}
+
+void gimli_decrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *m,
+                          const unsigned char *c, size_t blocks)
+{
+    for (; blocks > 0; --blocks)
+    {
+        unsigned i;
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            const uint32_t cw = gimli_load(&c[i * 4]);
+            gimli_store(&m[i * 4], state[i] ^ cw);
+            state[i] = cw;
+        }
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(state);
+        m += GIMLI_RATE;
+        c += GIMLI_RATE;
+    }
+}
+
+void gimli_decrypt_absorb_blocks(uint32_t state[GIMLI_WORDS],
+                                 uint32_t hash[GIMLI_WORDS], unsigned char *m,
+                                 const unsigned char *c, size_t blocks)
+{
+    for (; blocks > 0; --blocks)
+    {
+        unsigned i;
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            const uint32_t cw = gimli_load(&c[i * 4]);
+            const uint32_t mw = state[i] ^ cw;
+            gimli_store(&m[i * 4], mw);
+            state[i] = cw;
+            hash[i] ^= mw;
+        }
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(state);
+        gimli(hash);
+        m += GIMLI_RATE;
+        c += GIMLI_RATE;
+    }
+}
+
+void gimli_squeeze_blocks(uint32_t state[GIMLI_WORDS], unsigned char *h,
+                          size_t blocks)
+{
+    for (; blocks > 0; --blocks)
+    {
+        unsigned i;
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(state);
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            gimli_store(&h[i * 4], state[i]);
+        }
+        h += GIMLI_RATE;
+    }
+}
+
 #endif /* LITH_VECTORIZE */
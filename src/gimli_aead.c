@@ -5,6 +5,8 @@
 
 #include <lithium/gimli_aead.h>
 
+#include <lithium/gimli_hash.h>
+
 #include "gimli_common.h"
 #include "opt.h"
 
@@ -34,6 +36,17 @@ void gimli_aead_update_ad(gimli_state *g, const unsigned char *ad, size_t adlen)
     gimli_absorb(g, ad, adlen);
 }
 
+void gimli_aead_update_ad_words(gimli_state *g, const uint32_t *ad,
+                                size_t nwords)
+{
+    gimli_absorb_words(g, ad, nwords);
+}
+
+void gimli_aead_update_ad_iov(gimli_state *g, const lith_iovec *ad, size_t n)
+{
+    gimli_absorb_iov(g, ad, n);
+}
+
 void gimli_aead_final_ad(gimli_state *g)
 {
     gimli_pad(g);
@@ -41,11 +54,27 @@ void gimli_aead_final_ad(gimli_state *g)
     gimli_advance(g);
 }
 
+/* Encrypt without the block kernels, a word at a time where possible. */
 static void encrypt_update(gimli_state *g, unsigned char *c,
                            const unsigned char *m, size_t len)
 {
-    size_t i;
-    for (i = 0; i < len; ++i)
+    size_t i = 0;
+#if (LITH_SPONGE_WORDS)
+    for (; (i < len) && ((g->offset % 4) != 0); ++i)
+    {
+        gimli_absorb_byte(g, m[i]);
+        c[i] = gimli_squeeze_byte(g);
+        gimli_advance(g);
+    }
+    for (; len - i >= 4; i += 4)
+    {
+        uint32_t *const w = &g->state[g->offset / 4];
+        *w ^= gimli_load(&m[i]);
+        gimli_store(&c[i], *w);
+        gimli_advance_word(g);
+    }
+#endif
+    for (; i < len; ++i)
     {
         gimli_absorb_byte(g, m[i]);
         c[i] = gimli_squeeze_byte(g);
@@ -60,45 +89,78 @@ void gimli_aead_encrypt_update(gimli_state *g, unsigned char *c,
     const size_t first_block_len = (GIMLI_RATE - g->offset) % GIMLI_RATE;
     if (len >= GIMLI_RATE + first_block_len)
     {
+        const size_t blocks = (len - first_block_len) / GIMLI_RATE;
         encrypt_update(g, c, m, first_block_len);
         c += first_block_len;
         m += first_block_len;
-        len -= first_block_len;
-        do
-        {
-#if (LITH_SPONGE_VECTORS)
-            *(block *)c = (*(block *)g->state ^= *(const block *)m);
-            c += GIMLI_RATE;
-            m += GIMLI_RATE;
-#else
-            size_t i;
-            for (i = 0; i < GIMLI_RATE / 4; ++i)
-            {
-                g->state[i] ^= gimli_load(m);
-                gimli_store(c, g->state[i]);
-                c += 4;
-                m += 4;
-            }
-#endif
-            gimli(g->state);
-            len -= GIMLI_RATE;
-        } while (len >= GIMLI_RATE);
+        gimli_encrypt_blocks(g->state, c, m, blocks);
+        c += blocks * GIMLI_RATE;
+        m += blocks * GIMLI_RATE;
+        len -= first_block_len + blocks * GIMLI_RATE;
     }
 #endif
     encrypt_update(g, c, m, len);
 }
 
+void gimli_aead_encrypt_update_words(gimli_state *g, uint32_t *c,
+                                     const uint32_t *m, size_t nwords)
+{
+    size_t i;
+    unsigned b;
+    if ((g->offset % 4) == 0)
+    {
+        for (i = 0; i < nwords; ++i)
+        {
+            uint32_t *const w = &g->state[g->offset / 4];
+            *w ^= m[i];
+            c[i] = *w;
+            gimli_advance_word(g);
+        }
+        return;
+    }
+    /* The offset is in the middle of a word, so go a byte at a time. */
+    for (i = 0; i < nwords; ++i)
+    {
+        uint32_t cw = 0;
+        for (b = 0; b < 4; ++b)
+        {
+            gimli_absorb_byte(g, (unsigned char)((m[i] >> (b * 8)) & 0xFFU));
+            cw |= (uint32_t)gimli_squeeze_byte(g) << (b * 8);
+            gimli_advance(g);
+        }
+        c[i] = cw;
+    }
+}
+
 void gimli_aead_encrypt_final(gimli_state *g, unsigned char *t, size_t len)
 {
     gimli_pad(g);
     gimli_squeeze(g, t, len);
 }
 
+/* Decrypt without the block kernels, a word at a time where possible. */
 static void decrypt_update(gimli_state *g, unsigned char *m,
                            const unsigned char *c, size_t len)
 {
-    size_t i;
-    for (i = 0; i < len; ++i)
+    size_t i = 0;
+#if (LITH_SPONGE_WORDS)
+    for (; (i < len) && ((g->offset % 4) != 0); ++i)
+    {
+        m[i] = c[i] ^ gimli_squeeze_byte(g);
+        gimli_absorb_byte(g, m[i]);
+        gimli_advance(g);
+    }
+    for (; len - i >= 4; i += 4)
+    {
+        /* Absorbing the message word sets the state word to c. */
+        uint32_t *const w = &g->state[g->offset / 4];
+        const uint32_t cw = gimli_load(&c[i]);
+        gimli_store(&m[i], *w ^ cw);
+        *w = cw;
+        gimli_advance_word(g);
+    }
+#endif
+    for (; i < len; ++i)
     {
         m[i] = c[i] ^ gimli_squeeze_byte(g);
         gimli_absorb_byte(g, m[i]);
@@ -113,49 +175,103 @@ void gimli_aead_decrypt_update(gimli_state *g, unsigned char *m,
     const size_t first_block_len = (GIMLI_RATE - g->offset) % GIMLI_RATE;
     if (len >= GIMLI_RATE + first_block_len)
     {
+        const size_t blocks = (len - first_block_len) / GIMLI_RATE;
         decrypt_update(g, m, c, first_block_len);
         m += first_block_len;
         c += first_block_len;
-        len -= first_block_len;
-        do
-        {
-            /*
-             * We absorb the message data back into the gimli_state after
-             * outputting it, which amounts to:
-             * g->state ^= m;
-             * but we can rewrite as:
-             * g->state ^= g->state ^ c;
-             * and again as:
-             * g->state = g->state ^ g->state ^ c;
-             * and finally:
-             * g->state = c;
-             * This is easy to do when operating on words or blocks.
-             */
-#if (LITH_SPONGE_VECTORS)
-            const block cb = *(const block *)c;
-            *(block *)m = *(block *)g->state ^ cb;
-            *(block *)g->state = cb;
-            m += GIMLI_RATE;
-            c += GIMLI_RATE;
-#else
-            size_t i;
-            for (i = 0; i < GIMLI_RATE / 4; ++i)
-            {
-                const uint32_t cw = gimli_load(c);
-                gimli_store(m, g->state[i] ^ cw);
-                g->state[i] = cw;
-                m += 4;
-                c += 4;
-            }
-#endif
-            gimli(g->state);
-            len -= GIMLI_RATE;
-        } while (len >= GIMLI_RATE);
+        gimli_decrypt_blocks(g->state, m, c, blocks);
+        m += blocks * GIMLI_RATE;
+        c += blocks * GIMLI_RATE;
+        len -= first_block_len + blocks * GIMLI_RATE;
     }
 #endif
     decrypt_update(g, m, c, len);
 }
 
+/*
+ * Without the fused kernel, the plaintext is hashed a piece at a time, right
+ * after it is decrypted, so that it is still in the cache.
+ */
+#define DECRYPT_HASH_PIECE_LEN 1024U
+
+void gimli_aead_decrypt_update_hash(gimli_state *g, gimli_state *h,
+                                    unsigned char *m, const unsigned char *c,
+                                    size_t len)
+{
+#if (LITH_SPONGE_WORDS)
+    const size_t first_block_len = (GIMLI_RATE - g->offset) % GIMLI_RATE;
+    if ((len >= GIMLI_RATE + first_block_len) && (h->offset == g->offset))
+    {
+        const size_t blocks = (len - first_block_len) / GIMLI_RATE;
+        decrypt_update(g, m, c, first_block_len);
+        gimli_hash_update(h, m, first_block_len);
+        m += first_block_len;
+        c += first_block_len;
+        gimli_decrypt_absorb_blocks(g->state, h->state, m, c, blocks);
+        m += blocks * GIMLI_RATE;
+        c += blocks * GIMLI_RATE;
+        len -= first_block_len + blocks * GIMLI_RATE;
+    }
+#endif
+    while (len > 0)
+    {
+        const size_t piece =
+            (len < DECRYPT_HASH_PIECE_LEN) ? len : DECRYPT_HASH_PIECE_LEN;
+        gimli_aead_decrypt_update(g, m, c, piece);
+        gimli_hash_update(h, m, piece);
+        m += piece;
+        c += piece;
+        len -= piece;
+    }
+}
+
+void gimli_aead_decrypt_update_words(gimli_state *g, uint32_t *m,
+                                     const uint32_t *c, size_t nwords)
+{
+    size_t i;
+    unsigned b;
+    if ((g->offset % 4) == 0)
+    {
+        for (i = 0; i < nwords; ++i)
+        {
+            /* Absorbing the message word sets the state word to c. */
+            uint32_t *const w = &g->state[g->offset / 4];
+            const uint32_t cw = c[i];
+            m[i] = *w ^ cw;
+            *w = cw;
+            gimli_advance_word(g);
+        }
+        return;
+    }
+    /* The offset is in the middle of a word, so go a byte at a time. */
+    for (i = 0; i < nwords; ++i)
+    {
+        const uint32_t cw = c[i];
+        uint32_t mw = 0;
+        for (b = 0; b < 4; ++b)
+        {
+            const unsigned char mb = (unsigned char)(
+                ((cw >> (b * 8)) & 0xFFU) ^ gimli_squeeze_byte(g));
+            gimli_absorb_byte(g, mb);
+            mw |= (uint32_t)mb << (b * 8);
+            gimli_advance(g);
+        }
+        m[i] = mw;
+    }
+}
+
+void gimli_aead_encrypt_update_iov(gimli_state *g, const lith_iovec *c,
+                                   const lith_iovec *m, size_t n)
+{
+    gimli_update_iov(g, c, m, n, gimli_aead_encrypt_update);
+}
+
+void gimli_aead_decrypt_update_iov(gimli_state *g, const lith_iovec *m,
+                                   const lith_iovec *c, size_t n)
+{
+    gimli_update_iov(g, m, c, n, gimli_aead_decrypt_update);
+}
+
 bool gimli_aead_decrypt_final(gimli_state *g, const unsigned char *t,
                               size_t tlen)
 {
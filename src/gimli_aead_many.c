@@ -0,0 +1,414 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+
+#include <lithium/gimli.h>
+
+#include "gimli_common.h"
+#include "opt.h"
+
+#include <string.h>
+
+/* ok is NULL when encrypting. */
+struct aead_batch
+{
+    const gimli_aead_item *items;
+    bool *ok;
+    size_t n;
+    size_t tlen;
+};
+
+#if (LITH_VECTORIZE)
+
+#define LANE(s, word, lane) (s)[(word) * GIMLI_X_LANES + (lane)]
+
+/* Clear the output of a message whose tag is not valid. */
+static void aead_finish_item(const struct aead_batch *b, size_t item,
+                             bool valid)
+{
+    if (b->ok != NULL)
+    {
+        const gimli_aead_item *const it = &b->items[item];
+        const unsigned char mask = (unsigned char)(~(unsigned int)valid + 1);
+        size_t i;
+        for (i = 0; i < it->len; ++i)
+        {
+            it->out[i] &= mask;
+        }
+        b->ok[item] = valid;
+    }
+}
+
+/*
+ * Each lane processes one message at a time. After the nonce and key are
+ * loaded and permuted, a lane takes a block of associated data per step,
+ * then its padded last block, then a block of the message per step, and then
+ * its padded last block, after which each step outputs or checks a block of
+ * the tag. Lanes are refilled as soon as they finish, as in gimli_hash_many.
+ */
+enum aead_phase
+{
+    AEAD_IDLE,
+    AEAD_INIT,
+    AEAD_AD,
+    AEAD_MSG,
+    AEAD_TAG
+};
+
+struct aead_lane
+{
+    size_t item;
+    size_t pos;
+    enum aead_phase phase;
+    unsigned mismatch;
+};
+
+static void pad_lane(uint32_t *s, size_t lane, size_t offset)
+{
+    LANE(s, offset / 4, lane) ^= UINT32_C(0x01) << ((offset % 4) * 8);
+    LANE(s, GIMLI_WORDS - 1, lane) ^= UINT32_C(0x01000000);
+}
+
+static void ad_block(uint32_t *s, size_t lane, struct aead_lane *l,
+                     const gimli_aead_item *it)
+{
+    const size_t left = it->adlen - l->pos;
+    unsigned char last[GIMLI_RATE];
+    const unsigned char *block = last;
+    unsigned i;
+    if (left >= GIMLI_RATE)
+    {
+        block = &it->ad[l->pos];
+    }
+    else
+    {
+        (void)memset(last, 0, sizeof last);
+        if (left > 0)
+        {
+            (void)memcpy(last, &it->ad[l->pos], left);
+        }
+    }
+    for (i = 0; i < GIMLI_RATE / 4; ++i)
+    {
+        LANE(s, i, lane) ^= gimli_load(&block[i * 4]);
+    }
+    if (left < GIMLI_RATE)
+    {
+        pad_lane(s, lane, left);
+        l->phase = AEAD_MSG;
+        l->pos = 0;
+    }
+    else
+    {
+        l->pos += GIMLI_RATE;
+    }
+}
+
+static void msg_block(uint32_t *s, size_t lane, struct aead_lane *l,
+                      const gimli_aead_item *it, bool decrypt)
+{
+    const size_t left = it->len - l->pos;
+    const size_t len = (left < GIMLI_RATE) ? left : GIMLI_RATE;
+    unsigned char in[GIMLI_RATE], out[GIMLI_RATE];
+    unsigned i;
+
+    (void)memset(in, 0, sizeof in);
+    if (len > 0)
+    {
+        (void)memcpy(in, &it->in[l->pos], len);
+    }
+    for (i = 0; i < GIMLI_RATE / 4; ++i)
+    {
+        const uint32_t w = LANE(s, i, lane);
+        const uint32_t x = gimli_load(&in[i * 4]);
+        gimli_store(&out[i * 4], w ^ x);
+    }
+    /*
+     * The state absorbs the message, so after encryption it holds the
+     * ciphertext, and decryption absorbs its own output. Bytes past the end
+     * of a partial block are zero in the message.
+     */
+    if (decrypt)
+    {
+        (void)memset(&out[len], 0, sizeof out - len);
+    }
+    for (i = 0; i < GIMLI_RATE / 4; ++i)
+    {
+        LANE(s, i, lane) ^= gimli_load(decrypt ? &out[i * 4] : &in[i * 4]);
+    }
+    if (len > 0)
+    {
+        (void)memcpy(&it->out[l->pos], out, len);
+    }
+
+    if (left < GIMLI_RATE)
+    {
+        pad_lane(s, lane, left);
+        l->phase = AEAD_TAG;
+        l->pos = 0;
+    }
+    else
+    {
+        l->pos += GIMLI_RATE;
+    }
+}
+
+/* Output or check the next block of the tag, after the state is permuted. */
+static void tag_block(const struct aead_batch *b, const uint32_t *s,
+                      size_t lane, struct aead_lane *l)
+{
+    const gimli_aead_item *const it = &b->items[l->item];
+    const size_t left = b->tlen - l->pos;
+    const size_t len = (left < GIMLI_RATE) ? left : GIMLI_RATE;
+    unsigned char block[GIMLI_RATE];
+    size_t i;
+    for (i = 0; i < GIMLI_RATE / 4; ++i)
+    {
+        gimli_store(&block[i * 4], LANE(s, i, lane));
+    }
+    if (b->ok != NULL)
+    {
+        for (i = 0; i < len; ++i)
+        {
+            l->mismatch |= it->t[l->pos + i] ^ block[i];
+        }
+    }
+    else
+    {
+        (void)memcpy(&it->t[l->pos], block, len);
+    }
+    l->pos += len;
+    if (l->pos == b->tlen)
+    {
+        aead_finish_item(b, l->item, l->mismatch == 0);
+        l->phase = AEAD_IDLE;
+    }
+}
+
+/*
+ * Finish a message with the single-state functions, which is cheaper than
+ * permuting every lane when only a few of them are still in use. A lane in
+ * AEAD_AD or AEAD_MSG must have been permuted since its last input, and a lane
+ * in AEAD_TAG must not have been permuted since its last output. A lane in
+ * AEAD_INIT has not been permuted yet.
+ */
+static void aead_finish_lane(const struct aead_batch *b, const uint32_t *s,
+                             const struct aead_lane *l, size_t lane)
+{
+    const gimli_aead_item *const it = &b->items[l->item];
+    unsigned mismatch = l->mismatch;
+    size_t pos = l->pos;
+    gimli_state g;
+    unsigned i;
+
+    for (i = 0; i < GIMLI_WORDS; ++i)
+    {
+        g.state[i] = LANE(s, i, lane);
+    }
+    g.offset = 0;
+
+    if (l->phase == AEAD_TAG)
+    {
+        /*
+         * A block of the tag was just output and the state has not been
+         * permuted since, so the rest of the tag starts with a permutation.
+         */
+        g.offset = GIMLI_RATE;
+        while (pos < b->tlen)
+        {
+            unsigned char block[GIMLI_RATE];
+            const size_t len =
+                (b->tlen - pos < GIMLI_RATE) ? b->tlen - pos : GIMLI_RATE;
+            gimli_squeeze_more(&g, block, len);
+            if (b->ok != NULL)
+            {
+                for (i = 0; i < len; ++i)
+                {
+                    mismatch |= it->t[pos + i] ^ block[i];
+                }
+            }
+            else
+            {
+                (void)memcpy(&it->t[pos], block, len);
+            }
+            pos += len;
+        }
+        aead_finish_item(b, l->item, mismatch == 0);
+        return;
+    }
+
+    if (l->phase == AEAD_INIT)
+    {
+        gimli(g.state);
+    }
+    if (l->phase != AEAD_MSG)
+    {
+        gimli_aead_update_ad(&g, &it->ad[pos], it->adlen - pos);
+        gimli_aead_final_ad(&g);
+        pos = 0;
+    }
+    if (b->ok != NULL)
+    {
+        gimli_aead_decrypt_update(&g, &it->out[pos], &it->in[pos],
+                                  it->len - pos);
+        aead_finish_item(b, l->item,
+                         gimli_aead_decrypt_final(&g, it->t, b->tlen));
+    }
+    else
+    {
+        gimli_aead_encrypt_update(&g, &it->out[pos], &it->in[pos],
+                                  it->len - pos);
+        gimli_aead_encrypt_final(&g, it->t, b->tlen);
+    }
+}
+
+static void aead_lanes(const struct aead_batch *b)
+{
+    uint32_t s[GIMLI_WORDS * GIMLI_X_LANES];
+    struct aead_lane lanes[GIMLI_X_LANES];
+    size_t next = 0, lane;
+    unsigned i;
+
+    for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+    {
+        lanes[lane].phase = AEAD_IDLE;
+    }
+
+    for (;;)
+    {
+        size_t active = 0;
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            struct aead_lane *const l = &lanes[lane];
+            if ((l->phase == AEAD_IDLE) && (next < b->n))
+            {
+                const gimli_aead_item *const it = &b->items[next];
+                l->phase = AEAD_INIT;
+                l->item = next++;
+                l->pos = 0;
+                l->mismatch = 0;
+                for (i = 0; i < 4; ++i)
+                {
+                    LANE(s, i, lane) = gimli_load(&it->n[i * 4]);
+                }
+                for (i = 0; i < 8; ++i)
+                {
+                    LANE(s, 4 + i, lane) = gimli_load(&it->k[i * 4]);
+                }
+            }
+            if (l->phase != AEAD_IDLE)
+            {
+                ++active;
+            }
+        }
+
+        if (active == 0)
+        {
+            return;
+        }
+        if ((next == b->n) && (active * 4 <= GIMLI_X_LANES))
+        {
+            break;
+        }
+
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            struct aead_lane *const l = &lanes[lane];
+            switch (l->phase)
+            {
+            case AEAD_INIT:
+                l->phase = AEAD_AD;
+                break;
+            case AEAD_AD:
+                ad_block(s, lane, l, &b->items[l->item]);
+                break;
+            case AEAD_MSG:
+                msg_block(s, lane, l, &b->items[l->item], b->ok != NULL);
+                break;
+            case AEAD_IDLE:
+            case AEAD_TAG:
+                break;
+            }
+        }
+
+        gimli_x_lanes(s);
+
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            if (lanes[lane].phase == AEAD_TAG)
+            {
+                tag_block(b, s, lane, &lanes[lane]);
+            }
+        }
+    }
+
+    for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+    {
+        if (lanes[lane].phase != AEAD_IDLE)
+        {
+            aead_finish_lane(b, s, &lanes[lane], lane);
+        }
+    }
+}
+
+#endif /* LITH_VECTORIZE */
+
+static void aead_process(const struct aead_batch *b)
+{
+#if (LITH_VECTORIZE)
+    aead_lanes(b);
+#else
+    size_t i;
+    /*
+     * Without vector units there is no wider permutation to share, so
+     * process each message in turn.
+     */
+    for (i = 0; i < b->n; ++i)
+    {
+        const gimli_aead_item *const it = &b->items[i];
+        if (b->ok != NULL)
+        {
+            b->ok[i] = gimli_aead_decrypt(it->out, it->in, it->len, it->t,
+                                          b->tlen, it->ad, it->adlen, it->n,
+                                          it->k);
+        }
+        else
+        {
+            gimli_aead_encrypt(it->out, it->t, b->tlen, it->in, it->len, it->ad,
+                               it->adlen, it->n, it->k);
+        }
+    }
+#endif
+}
+
+void gimli_aead_encrypt_many(const gimli_aead_item items[], size_t n,
+                             size_t tlen)
+{
+    struct aead_batch b;
+    b.items = items;
+    b.n = n;
+    b.tlen = tlen;
+    b.ok = NULL;
+    aead_process(&b);
+}
+
+bool gimli_aead_decrypt_many(bool ok[], const gimli_aead_item items[],
+                             size_t n, size_t tlen)
+{
+    struct aead_batch b;
+    bool all = true;
+    size_t i;
+    b.items = items;
+    b.n = n;
+    b.tlen = tlen;
+    b.ok = ok;
+    aead_process(&b);
+    for (i = 0; i < n; ++i)
+    {
+        all = all && ok[i];
+    }
+    return all;
+}
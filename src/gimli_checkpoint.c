@@ -0,0 +1,66 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_checkpoint.h>
+
+#include "gimli_common.h"
+
+void gimli_checkpoint_init(gimli_checkpoint_state *c, uint64_t interval)
+{
+    gimli_hash_init(&c->hash);
+    c->pos = 0;
+    c->interval = interval;
+    c->pad = 0;
+}
+
+static void store_pos(unsigned char p[8], uint64_t pos)
+{
+    gimli_store(p, (uint32_t)(pos & UINT32_C(0xFFFFFFFF)));
+    gimli_store(&p[4], (uint32_t)(pos >> 32));
+}
+
+static uint64_t load_pos(const unsigned char p[8])
+{
+    return (uint64_t)gimli_load(p) | ((uint64_t)gimli_load(&p[4]) << 32);
+}
+
+void gimli_checkpoint_update(gimli_checkpoint_state *c, const unsigned char *m,
+                             size_t len, gimli_checkpoint_fn *fn, void *ctx)
+{
+    while (len > 0)
+    {
+        const uint64_t to_next = c->interval - (c->pos % c->interval);
+        const size_t take = (len < to_next) ? len : (size_t)to_next;
+        gimli_hash_update(&c->hash, m, take);
+        c->pos += take;
+        m += take;
+        len -= take;
+        if ((c->pos % c->interval) == 0)
+        {
+            unsigned char entry[GIMLI_CHECKPOINT_LEN];
+            store_pos(entry, c->pos);
+            gimli_export(&c->hash, &entry[8], GIMLI_EXPORT_KIND_CHECKPOINT,
+                         entry, 8);
+            fn(ctx, entry);
+        }
+    }
+}
+
+bool gimli_checkpoint_resume(gimli_checkpoint_state *c,
+                             const unsigned char entry[GIMLI_CHECKPOINT_LEN],
+                             uint64_t interval)
+{
+    gimli_hash_state hash;
+    const uint64_t pos = load_pos(entry);
+    if ((interval == 0) || ((pos % interval) != 0) ||
+        !gimli_import(&hash, &entry[8], GIMLI_EXPORT_KIND_CHECKPOINT, entry, 8))
+    {
+        return false;
+    }
+    c->hash = hash;
+    c->pos = pos;
+    c->interval = interval;
+    return true;
+}
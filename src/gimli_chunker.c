@@ -0,0 +1,158 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_chunker.h>
+
+#include "gimli_common.h"
+
+#include <string.h>
+
+/*
+ * The rolling hash is shifted left by one bit per byte, so after 32 bytes it
+ * only depends on the last 32 bytes, and the top bits depend on all of them.
+ * A boundary is where the top bits of the hash are zero. More bits are tested
+ * before the average length than after it, which narrows the distribution of
+ * chunk lengths.
+ */
+#define WINDOW 32U
+#define MASK_SHORT UINT32_C(0xFFFE0000)
+#define MASK_LONG UINT32_C(0xFFE00000)
+
+void gimli_chunker_init(gimli_chunker_state *c,
+                        const unsigned char key[GIMLI_CHUNK_KEY_LEN])
+{
+    unsigned char gear[sizeof c->gear];
+    gimli_state g;
+    unsigned i;
+
+    gimli_init_tagged(&g, GIMLI_TAG_CHUNK_GEAR);
+    gimli_absorb(&g, key, GIMLI_CHUNK_KEY_LEN);
+    gimli_pad(&g);
+    gimli_squeeze(&g, gear, sizeof gear);
+    for (i = 0; i < 256; ++i)
+    {
+        c->gear[i] = gimli_load(&gear[i * 4]);
+    }
+    gimli_hash_init(&c->hash);
+    c->offset = 0;
+    c->len = 0;
+    c->roll = 0;
+    c->pad = 0;
+}
+
+/*
+ * Roll the hash over m[*i, to), testing for a boundary after each byte with
+ * mask. Returns true with *i after the boundary if there is one.
+ */
+static bool roll(gimli_chunker_state *c, const unsigned char *m, size_t *i,
+                 size_t to, uint32_t mask)
+{
+    uint32_t h = c->roll;
+    size_t j;
+    for (j = *i; j < to; ++j)
+    {
+        h = (h << 1) + c->gear[m[j]];
+        if ((h & mask) == 0)
+        {
+            c->roll = h;
+            *i = j + 1;
+            return true;
+        }
+    }
+    c->roll = h;
+    *i = to;
+    return false;
+}
+
+/* The offset in m of position pos of the chunk, limited to [0, n]. */
+static size_t until(uint32_t start, uint32_t pos, size_t n)
+{
+    if (pos <= start)
+    {
+        return 0;
+    }
+    return (pos - start < n) ? pos - start : n;
+}
+
+/*
+ * Find the next boundary in the len bytes of m, which continue the current
+ * chunk. Returns the number of bytes up to the boundary, or the number of
+ * bytes that belong to the chunk if it does not end in m.
+ */
+static size_t find_boundary(gimli_chunker_state *c, const unsigned char *m,
+                            size_t len, bool *cut)
+{
+    const uint32_t start = c->len;
+    const size_t n = (len < GIMLI_CHUNK_MAX_LEN - start)
+                         ? len
+                         : GIMLI_CHUNK_MAX_LEN - start;
+    const size_t min = until(start, GIMLI_CHUNK_MIN_LEN, n);
+    const size_t avg = until(start, GIMLI_CHUNK_AVG_LEN, n);
+    /*
+     * No boundary is allowed before the minimum length, and the hash only
+     * depends on the last WINDOW bytes, so skip the bytes before those.
+     */
+    size_t i = until(start, GIMLI_CHUNK_MIN_LEN - WINDOW, n);
+    uint32_t h = c->roll;
+
+    for (; i < min; ++i)
+    {
+        h = (h << 1) + c->gear[m[i]];
+    }
+    c->roll = h;
+    *cut = roll(c, m, &i, avg, MASK_SHORT) || roll(c, m, &i, n, MASK_LONG) ||
+           (start + n == GIMLI_CHUNK_MAX_LEN);
+    return i;
+}
+
+static void emit(gimli_chunker_state *c, gimli_chunk_fn *fn, void *ctx)
+{
+    gimli_chunk chunk;
+    chunk.offset = c->offset;
+    chunk.len = c->len;
+    gimli_hash_final(&c->hash, chunk.digest, sizeof chunk.digest);
+    fn(ctx, &chunk);
+    gimli_hash_init(&c->hash);
+    c->offset += c->len;
+    c->len = 0;
+    c->roll = 0;
+}
+
+void gimli_chunker_update(gimli_chunker_state *c, const unsigned char *m,
+                          size_t len, gimli_chunk_fn *fn, void *ctx)
+{
+    while (len > 0)
+    {
+        bool cut;
+        const size_t n = find_boundary(c, m, len, &cut);
+        gimli_hash_update(&c->hash, m, n);
+        c->len += (uint32_t)n;
+        m += n;
+        len -= n;
+        if (cut)
+        {
+            emit(c, fn, ctx);
+        }
+    }
+}
+
+void gimli_chunker_final(gimli_chunker_state *c, gimli_chunk_fn *fn,
+                         void *ctx)
+{
+    if (c->len > 0)
+    {
+        emit(c, fn, ctx);
+    }
+}
+
+void gimli_chunk_encode(unsigned char entry[GIMLI_CHUNK_ENTRY_LEN],
+                        const gimli_chunk *chunk)
+{
+    gimli_store(entry, (uint32_t)(chunk->offset & UINT32_C(0xFFFFFFFF)));
+    gimli_store(&entry[4], (uint32_t)(chunk->offset >> 32));
+    gimli_store(&entry[8], (uint32_t)(chunk->len & UINT32_C(0xFFFFFFFF)));
+    gimli_store(&entry[12], (uint32_t)(chunk->len >> 32));
+    (void)memcpy(&entry[16], chunk->digest, GIMLI_CHUNK_DIGEST_LEN);
+}
@@ -12,111 +12,286 @@
 
 #include <string.h>
 
-uint32_t gimli_load(const unsigned char *p)
+/*
+ * Absorb without the block kernels. With LITH_SPONGE_WORDS, only the bytes
+ * before the next word boundary and after the last whole word are absorbed
+ * individually.
+ */
+static void absorb(gimli_state *g, const unsigned char *m, size_t len)
 {
-    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
-           (uint32_t)p[3] << 24;
+    size_t i = 0;
+#if (LITH_SPONGE_WORDS)
+    for (; (i < len) && ((g->offset % 4) != 0); ++i)
+    {
+        gimli_absorb_byte(g, m[i]);
+        gimli_advance(g);
+    }
+    for (; len - i >= 4; i += 4)
+    {
+        g->state[g->offset / 4] ^= gimli_load(&m[i]);
+        gimli_advance_word(g);
+    }
+#endif
+    for (; i < len; ++i)
+    {
+        gimli_absorb_byte(g, m[i]);
+        gimli_advance(g);
+    }
 }
 
-void gimli_store(unsigned char *p, uint32_t x)
+void gimli_absorb(gimli_state *g, const unsigned char *m, size_t len)
 {
-    p[0] = (unsigned char)(x & 0xFFU);
-    p[1] = (unsigned char)((x >> 8) & 0xFFU);
-    p[2] = (unsigned char)((x >> 16) & 0xFFU);
-    p[3] = (unsigned char)((x >> 24) & 0xFFU);
-}
-
-#if (LITH_LITTLE_ENDIAN)
-#define OFFSET_SWAP 0U
-#elif (LITH_BIG_ENDIAN)
-#define OFFSET_SWAP 3U
+#if (LITH_SPONGE_WORDS)
+    const size_t first_block_len = (GIMLI_RATE - g->offset) % GIMLI_RATE;
+    if (len >= GIMLI_RATE + first_block_len)
+    {
+        const size_t blocks = (len - first_block_len) / GIMLI_RATE;
+        absorb(g, m, first_block_len);
+        m += first_block_len;
+        gimli_absorb_blocks(g->state, m, blocks);
+        m += blocks * GIMLI_RATE;
+        len -= first_block_len + blocks * GIMLI_RATE;
+    }
 #endif
+    absorb(g, m, len);
+}
 
-void gimli_absorb_byte(gimli_state *g, unsigned char x)
+void gimli_absorb_words(gimli_state *g, const uint32_t *w, size_t nwords)
 {
-#if defined(__TMS320C2000__)
-    __byte((int *)g->state, g->offset) ^= x;
-#elif ((LITH_LITTLE_ENDIAN || LITH_BIG_ENDIAN) && (CHAR_BIT == 8))
-    ((unsigned char *)g->state)[g->offset ^ OFFSET_SWAP] ^= x;
-#else
-    g->state[g->offset / 4] ^= (uint32_t)x << ((g->offset % 4) * 8);
-#endif
+    size_t i;
+    unsigned b;
+    if ((g->offset % 4) == 0)
+    {
+        for (i = 0; i < nwords; ++i)
+        {
+            g->state[g->offset / 4] ^= w[i];
+            gimli_advance_word(g);
+        }
+        return;
+    }
+    /*
+     * An earlier byte update left the offset in the middle of a word, so each
+     * input word straddles two state words.
+     */
+    for (i = 0; i < nwords; ++i)
+    {
+        for (b = 0; b < 4; ++b)
+        {
+            gimli_absorb_byte(g, (unsigned char)((w[i] >> (b * 8)) & 0xFFU));
+            gimli_advance(g);
+        }
+    }
 }
 
-unsigned char gimli_squeeze_byte(const gimli_state *g)
+/*
+ * Copy up to len bytes from the fragments, starting at *pos in fragment *i,
+ * and advance past them. Returns the number of bytes copied.
+ */
+static size_t gather(unsigned char *dst, size_t len, const lith_iovec *iov,
+                     size_t n, size_t *i, size_t *pos)
 {
-#if defined(__TMS320C2000__)
-    return (unsigned char)__byte((int *)g->state, g->offset);
-#elif ((LITH_LITTLE_ENDIAN || LITH_BIG_ENDIAN) && (CHAR_BIT == 8))
-    return ((const unsigned char *)g->state)[g->offset ^ OFFSET_SWAP];
-#else
-    return (unsigned char)((g->state[g->offset / 4] >> ((g->offset % 4) * 8)) &
-                           0xFFU);
-#endif
+    size_t got = 0;
+    while ((got < len) && (*i < n))
+    {
+        const size_t left = iov[*i].len - *pos;
+        const size_t take = (left < len - got) ? left : len - got;
+        (void)memcpy(&dst[got], (const unsigned char *)iov[*i].base + *pos,
+                     take);
+        got += take;
+        *pos += take;
+        if (*pos == iov[*i].len)
+        {
+            ++*i;
+            *pos = 0;
+        }
+    }
+    return got;
 }
 
-void gimli_advance(gimli_state *g)
+/* Copy len bytes to the fragments, starting at pos in fragment i. */
+static void scatter(const lith_iovec *iov, size_t i, size_t pos,
+                    const unsigned char *src, size_t len)
 {
-    ++g->offset;
-    if (g->offset == GIMLI_RATE)
+    while (len > 0)
     {
-#if (LITH_ENABLE_WATCHDOG)
-        lith_watchdog_pet();
-#endif
-        gimli(g->state);
-        g->offset = 0;
+        const size_t left = iov[i].len - pos;
+        const size_t take = (left < len) ? left : len;
+        (void)memcpy((unsigned char *)iov[i].base + pos, src, take);
+        src += take;
+        len -= take;
+        ++i;
+        pos = 0;
     }
 }
 
-static void absorb(gimli_state *g, const unsigned char *m, size_t len)
+void gimli_update_iov(gimli_state *g, const lith_iovec *out,
+                      const lith_iovec *in, size_t n, gimli_update_fn *fn)
 {
-    size_t i;
-    for (i = 0; i < len; ++i)
+    unsigned char block_in[GIMLI_RATE], block_out[GIMLI_RATE];
+    size_t i = 0, pos = 0;
+    while (i < n)
     {
-        gimli_absorb_byte(g, m[i]);
-        gimli_advance(g);
+        const size_t left = in[i].len - pos;
+        const size_t to_block = (GIMLI_RATE - g->offset) % GIMLI_RATE;
+        if (left == 0)
+        {
+            ++i;
+            pos = 0;
+        }
+        else if (left >= to_block + GIMLI_RATE)
+        {
+            /* Stop at the last block boundary in the fragment. */
+            const size_t len = left - ((left - to_block) % GIMLI_RATE);
+            fn(g, (out != NULL) ? (unsigned char *)out[i].base + pos : NULL,
+               (const unsigned char *)in[i].base + pos, len);
+            pos += len;
+        }
+        else
+        {
+            /*
+             * Gather the rest of the current block, which may span several
+             * fragments. The input is gathered before any output is written,
+             * so out may be the same as in.
+             */
+            const size_t start_i = i, start_pos = pos;
+            const size_t need = (to_block == 0) ? GIMLI_RATE : to_block;
+            const size_t got = gather(block_in, need, in, n, &i, &pos);
+            fn(g, block_out, block_in, got);
+            if (out != NULL)
+            {
+                scatter(out, start_i, start_pos, block_out, got);
+            }
+        }
     }
 }
 
-void gimli_absorb(gimli_state *g, const unsigned char *m, size_t len)
+static void absorb_update(gimli_state *g, unsigned char *out,
+                          const unsigned char *in, size_t len)
 {
-#if (LITH_SPONGE_WORDS)
-    const unsigned first_block_len = (GIMLI_RATE - g->offset) % GIMLI_RATE;
-    if (len >= GIMLI_RATE + first_block_len)
+    (void)out;
+    gimli_absorb(g, in, len);
+}
+
+void gimli_absorb_iov(gimli_state *g, const lith_iovec *iov, size_t n)
+{
+    gimli_update_iov(g, NULL, iov, n, absorb_update);
+}
+
+void gimli_squeeze(gimli_state *g, unsigned char *h, size_t len)
+{
+    g->offset = GIMLI_RATE;
+    gimli_squeeze_more(g, h, len);
+}
+
+void gimli_squeeze_more(gimli_state *g, unsigned char *h, size_t len)
+{
+    while (len > 0)
     {
-        absorb(g, m, first_block_len);
-        m += first_block_len;
-        len -= first_block_len;
-        do
+        if (g->offset == GIMLI_RATE)
         {
-#if (LITH_SPONGE_VECTORS)
-            *(block *)g->state ^= *(const block *)m;
-            m += GIMLI_RATE;
-#else
-            size_t i;
-            for (i = 0; i < GIMLI_RATE / 4; ++i)
+#if (LITH_SPONGE_WORDS)
+            if (len >= GIMLI_RATE)
             {
-                g->state[i] ^= gimli_load(m);
-                m += 4;
+                const size_t blocks = len / GIMLI_RATE;
+                gimli_squeeze_blocks(g->state, h, blocks);
+                h += blocks * GIMLI_RATE;
+                len -= blocks * GIMLI_RATE;
+                continue;
             }
+#endif
+#if (LITH_ENABLE_WATCHDOG)
+            lith_watchdog_pet();
 #endif
             gimli(g->state);
-            len -= GIMLI_RATE;
-        } while (len >= GIMLI_RATE);
-    }
+            g->offset = 0;
+        }
+#if (LITH_SPONGE_WORDS)
+        if (((g->offset % 4) == 0) && (len >= 4))
+        {
+            gimli_store(h, g->state[g->offset / 4]);
+            g->offset += 4;
+            h += 4;
+            len -= 4;
+            continue;
+        }
 #endif
-    absorb(g, m, len);
+        *h = gimli_squeeze_byte(g);
+        ++g->offset;
+        ++h;
+        --len;
+    }
 }
 
-void gimli_squeeze(gimli_state *g, unsigned char *h, size_t len)
+void gimli_init_tagged(gimli_state *g, uint32_t tag)
 {
-    size_t i;
-    g->offset = GIMLI_RATE - 1;
-    for (i = 0; i < len; ++i)
+    (void)memset(g, 0, sizeof *g);
+    g->state[GIMLI_RATE / 4] = tag;
+}
+
+static void export_check(unsigned char check[GIMLI_EXPORT_CHECK_LEN],
+                         const unsigned char *in, const unsigned char *ad,
+                         size_t adlen)
+{
+    gimli_state c;
+    gimli_init_tagged(&c, GIMLI_TAG_EXPORT);
+    gimli_absorb(&c, ad, adlen);
+    gimli_absorb(&c, in, GIMLI_EXPORT_LEN - GIMLI_EXPORT_CHECK_LEN);
+    gimli_pad(&c);
+    gimli_squeeze(&c, check, GIMLI_EXPORT_CHECK_LEN);
+}
+
+void gimli_export(const gimli_state *g, unsigned char out[GIMLI_EXPORT_LEN],
+                  unsigned char kind, const unsigned char *ad, size_t adlen)
+{
+    unsigned i;
+    out[0] = GIMLI_EXPORT_VERSION;
+    out[1] = kind;
+    out[2] = (unsigned char)g->offset;
+    out[3] = 0;
+    for (i = 0; i < GIMLI_WORDS; ++i)
     {
-        gimli_advance(g);
-        h[i] = gimli_squeeze_byte(g);
+        gimli_store(&out[4 + i * 4], g->state[i]);
+    }
+    export_check(&out[GIMLI_EXPORT_LEN - GIMLI_EXPORT_CHECK_LEN], out, ad,
+                 adlen);
+}
+
+bool gimli_import(gimli_state *g, const unsigned char in[GIMLI_EXPORT_LEN],
+                  unsigned char kind, const unsigned char *ad, size_t adlen)
+{
+    unsigned char check[GIMLI_EXPORT_CHECK_LEN];
+    const unsigned char *in_check;
+    unsigned char mismatch = 0;
+    unsigned i;
+
+    for (i = 0; i < GIMLI_EXPORT_LEN; ++i)
+    {
+        /* Each byte must hold an octet, even if CHAR_BIT > 8. */
+        mismatch |= (unsigned char)(in[i] & ~0xFFU);
+    }
+    export_check(check, in, ad, adlen);
+    in_check = &in[GIMLI_EXPORT_LEN - GIMLI_EXPORT_CHECK_LEN];
+    for (i = 0; i < GIMLI_EXPORT_CHECK_LEN; ++i)
+    {
+        mismatch |= check[i] ^ in_check[i];
+    }
+    /*
+     * The check value is not keyed, so anyone can produce one. The offset of
+     * an absorbing state is always less than GIMLI_RATE, and the next update
+     * would write past the rate with anything larger.
+     */
+    if ((mismatch != 0) || (in[0] != GIMLI_EXPORT_VERSION) || (in[1] != kind) ||
+        (in[2] >= GIMLI_RATE) || (in[3] != 0))
+    {
+        return false;
+    }
+
+    g->offset = in[2];
+    for (i = 0; i < GIMLI_WORDS; ++i)
+    {
+        g->state[i] = gimli_load(&in[4 + i * 4]);
     }
+    return true;
 }
 
 void gimli_pad(gimli_state *g)
@@ -6,26 +6,231 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <lithium/gimli.h>
 #include <lithium/gimli_state.h>
+#include <lithium/iovec.h>
+#include <lithium/watchdog.h>
 
+#include "opt.h"
+
+#include <stdbool.h>
 #include <stdint.h>
 
-void gimli_absorb_byte(gimli_state *g, unsigned char x);
+/*
+ * Domain separation tags, which are XORed into the first capacity word of the
+ * initial state. Tag 0 is plain Gimli-Hash.
+ */
+#define GIMLI_TAG_TREE_LEAF 1U
+#define GIMLI_TAG_TREE_PARENT 2U
+#define GIMLI_TAG_TREE_SIGN 3U
+#define GIMLI_TAG_EXPORT 4U
+#define GIMLI_TAG_SHORT_HASH_64 5U
+#define GIMLI_TAG_SHORT_HASH_128 6U
+#define GIMLI_TAG_CHUNK_GEAR 7U
+#define GIMLI_TAG_CTR_STREAM 8U
+#define GIMLI_TAG_CTR_MAC 9U
+#define GIMLI_TAG_CTR_AD 10U
+#define GIMLI_TAG_CTR_FINAL 11U
+#define GIMLI_TAG_STROBE 12U
 
-unsigned char gimli_squeeze_byte(const gimli_state *g);
+/*
+ * Portable state export, used by gimli_hash_export and lith_sign_export.
+ * The layout is a version byte, a kind byte that identifies the API that
+ * exported the state, the offset, a zero byte, the state words in
+ * little-endian order, and an 8-byte check value, which is a tagged hash of
+ * adlen bytes of associated data and everything before it in the export. The
+ * associated data is not part of the export. Each byte holds an octet, so the
+ * layout is the same on targets where CHAR_BIT is not 8.
+ */
+#define GIMLI_EXPORT_VERSION 1U
+#define GIMLI_EXPORT_KIND_HASH 1U
+#define GIMLI_EXPORT_KIND_SIGN 2U
+#define GIMLI_EXPORT_KIND_CHECKPOINT 3U
+#define GIMLI_EXPORT_CHECK_LEN 8U
+#define GIMLI_EXPORT_LEN (4U + GIMLI_WORDS * 4U + GIMLI_EXPORT_CHECK_LEN)
 
-void gimli_advance(gimli_state *g);
+void gimli_export(const gimli_state *g, unsigned char out[GIMLI_EXPORT_LEN],
+                  unsigned char kind, const unsigned char *ad, size_t adlen);
 
-void gimli_pad(gimli_state *g);
+/* Returns false, leaving g unchanged, if the input is not a valid export. */
+bool gimli_import(gimli_state *g, const unsigned char in[GIMLI_EXPORT_LEN],
+                  unsigned char kind, const unsigned char *ad, size_t adlen);
 
-uint32_t gimli_load(const unsigned char *p);
+/* Initialize a hash state for the domain given by tag. */
+void gimli_init_tagged(gimli_state *g, uint32_t tag);
 
-void gimli_store(unsigned char *p, uint32_t x);
+/*
+ * gimli_hash_many, with each state starting as a copy of init, which must be
+ * at the start of a block.
+ */
+void gimli_hash_many_from(unsigned char *const outs[], size_t out_len,
+                          const gimli_state *init,
+                          const unsigned char *const msgs[],
+                          const size_t lens[], size_t n);
+
+/* gimli_hash_many, with each state initialized by gimli_init_tagged. */
+void gimli_hash_many_tagged(unsigned char *const outs[], size_t out_len,
+                            const unsigned char *const msgs[],
+                            const size_t lens[], size_t n, uint32_t tag);
+
+#if (LITH_VECTORIZE)
+/*
+ * The widest multi-state permutation that fits in one vector register, for
+ * processing independent messages in lanes.
+ */
+#if defined(__AVX512F__)
+#define GIMLI_X_LANES 16U
+#define gimli_x_lanes gimli_x16
+#elif defined(__AVX2__)
+#define GIMLI_X_LANES 8U
+#define gimli_x_lanes gimli_x8
+#else
+#define GIMLI_X_LANES 4U
+#define gimli_x_lanes gimli_x4
+#endif
+#endif /* LITH_VECTORIZE */
+
+void gimli_pad(gimli_state *g);
 
 void gimli_absorb(gimli_state *g, const unsigned char *m, size_t len);
 
+/*
+ * Absorb words, which are in little-endian order relative to the bytes
+ * absorbed by gimli_absorb.
+ */
+void gimli_absorb_words(gimli_state *g, const uint32_t *w, size_t nwords);
+
+/*
+ * A byte update function: gimli_aead_encrypt_update, gimli_aead_decrypt_update,
+ * or, with out ignored, an absorb.
+ */
+typedef void gimli_update_fn(gimli_state *g, unsigned char *out,
+                             const unsigned char *in, size_t len);
+
+/*
+ * Call fn on the n fragments of in, and the matching fragments of out, which
+ * may be NULL if fn has no output, or in itself. Each run of whole blocks
+ * within a fragment is passed to fn directly, and a block that spans
+ * fragments is gathered first, so that fn can use its block kernels for it.
+ */
+void gimli_update_iov(gimli_state *g, const lith_iovec *out,
+                      const lith_iovec *in, size_t n, gimli_update_fn *fn);
+
+void gimli_absorb_iov(gimli_state *g, const lith_iovec *iov, size_t n);
+
+/* Pad must be called before starting to squeeze. */
 void gimli_squeeze(gimli_state *g, unsigned char *h, size_t len);
 
+/*
+ * Squeeze the next len bytes after a previous gimli_squeeze or
+ * gimli_squeeze_more. An offset of GIMLI_RATE means that the state must be
+ * permuted before the next byte is output.
+ */
+void gimli_squeeze_more(gimli_state *g, unsigned char *h, size_t len);
+
 #define GIMLI_RATE 16U
 
+/*
+ * The per-byte and per-word sponge primitives are defined here rather than in
+ * gimli_common.c, so that they are inlined into their callers in other
+ * translation units without link-time optimization.
+ */
+
+LITH_INLINE uint32_t gimli_load(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+           (uint32_t)p[3] << 24;
+}
+
+LITH_INLINE void gimli_store(unsigned char *p, uint32_t x)
+{
+    p[0] = (unsigned char)(x & 0xFFU);
+    p[1] = (unsigned char)((x >> 8) & 0xFFU);
+    p[2] = (unsigned char)((x >> 16) & 0xFFU);
+    p[3] = (unsigned char)((x >> 24) & 0xFFU);
+}
+
+#if (LITH_LITTLE_ENDIAN)
+#define OFFSET_SWAP 0U
+#elif (LITH_BIG_ENDIAN)
+#define OFFSET_SWAP 3U
+#endif
+
+LITH_INLINE void gimli_absorb_byte(gimli_state *g, unsigned char x)
+{
+#if defined(__TMS320C2000__)
+    __byte((int *)g->state, g->offset) ^= x;
+#elif ((LITH_LITTLE_ENDIAN || LITH_BIG_ENDIAN) && (CHAR_BIT == 8))
+    ((unsigned char *)g->state)[g->offset ^ OFFSET_SWAP] ^= x;
+#else
+    g->state[g->offset / 4] ^= (uint32_t)x << ((g->offset % 4) * 8);
+#endif
+}
+
+LITH_INLINE unsigned char gimli_squeeze_byte(const gimli_state *g)
+{
+#if defined(__TMS320C2000__)
+    return (unsigned char)__byte((int *)g->state, g->offset);
+#elif ((LITH_LITTLE_ENDIAN || LITH_BIG_ENDIAN) && (CHAR_BIT == 8))
+    return ((const unsigned char *)g->state)[g->offset ^ OFFSET_SWAP];
+#else
+    return (unsigned char)((g->state[g->offset / 4] >> ((g->offset % 4) * 8)) &
+                           0xFFU);
+#endif
+}
+
+LITH_INLINE void gimli_advance(gimli_state *g)
+{
+    ++g->offset;
+    if (g->offset == GIMLI_RATE)
+    {
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(g->state);
+        g->offset = 0;
+    }
+}
+
+/* Advance by a whole word. The offset must be a multiple of 4. */
+LITH_INLINE void gimli_advance_word(gimli_state *g)
+{
+    g->offset += 4;
+    if (g->offset == GIMLI_RATE)
+    {
+#if (LITH_ENABLE_WATCHDOG)
+        lith_watchdog_pet();
+#endif
+        gimli(g->state);
+        g->offset = 0;
+    }
+}
+
+/*
+ * Fused sponge kernels for whole blocks, which must start at offset 0. Each
+ * block is absorbed (and for encryption and decryption, output) and then the
+ * state is permuted. These are implemented in gimli.c so that the state can
+ * stay in registers for the whole run of blocks.
+ */
+void gimli_absorb_blocks(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                         size_t blocks);
+
+void gimli_encrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *c,
+                          const unsigned char *m, size_t blocks);
+
+void gimli_decrypt_blocks(uint32_t state[GIMLI_WORDS], unsigned char *m,
+                          const unsigned char *c, size_t blocks);
+
+/*
+ * Decrypt blocks with the duplex state, and absorb the plaintext into the
+ * sponge state hash, permuting both states after each block.
+ */
+void gimli_decrypt_absorb_blocks(uint32_t state[GIMLI_WORDS],
+                                 uint32_t hash[GIMLI_WORDS], unsigned char *m,
+                                 const unsigned char *c, size_t blocks);
+
+/* Permute and then output a block, for each block. */
+void gimli_squeeze_blocks(uint32_t state[GIMLI_WORDS], unsigned char *h,
+                          size_t blocks);
+
 #endif /* LITHIUM_GIMLI_COMMON_H */
@@ -0,0 +1,288 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_ctr.h>
+
+#include "gimli_common.h"
+#include "opt.h"
+
+#include <string.h>
+
+/*
+ * Each block is the base state with a domain tag in the first capacity word
+ * and the 64-bit block index in the third and fourth. The duplex of gimli_aead
+ * starts from the same base state for the same nonce and key, but never
+ * touches those words, so the tags also keep the blocks apart from it.
+ */
+#define CTR_TAG_WORD (GIMLI_RATE / 4)
+#define CTR_INDEX_WORD (GIMLI_RATE / 4 + 4)
+#define CTR_ADLEN_WORD CTR_INDEX_WORD
+#define CTR_CLEN_WORD (CTR_INDEX_WORD + 2)
+
+#if (LITH_VECTORIZE)
+#define CTR_LANES GIMLI_X_LANES
+#define ctr_permute_lanes gimli_x_lanes
+#else
+#define CTR_LANES 1U
+#define ctr_permute_lanes gimli
+#endif
+
+/*
+ * Encryption and decryption alternate between the keystream and the MAC a
+ * segment at a time, so that the MAC reads the ciphertext from the cache.
+ */
+#define CTR_SEGMENT_LEN (256U * GIMLI_RATE)
+
+/*
+ * Permute count states, for the blocks first, first + 1, etc., and return the
+ * rate of each state. If m is not NULL, block i of m is XORed into the rate
+ * of state i first.
+ */
+static void ctr_permute(uint32_t rate[CTR_LANES][GIMLI_RATE / 4],
+                        const gimli_ctr_state *s, uint32_t tag, uint64_t first,
+                        const unsigned char *m, size_t count)
+{
+    uint32_t x[GIMLI_WORDS * CTR_LANES];
+    size_t lane;
+    unsigned w;
+    for (w = 0; w < GIMLI_WORDS; ++w)
+    {
+        for (lane = 0; lane < CTR_LANES; ++lane)
+        {
+            x[w * CTR_LANES + lane] = s->base[w];
+        }
+    }
+    for (lane = 0; lane < count; ++lane)
+    {
+        const uint64_t index = first + lane;
+        x[CTR_TAG_WORD * CTR_LANES + lane] ^= tag;
+        x[CTR_INDEX_WORD * CTR_LANES + lane] ^= (uint32_t)index;
+        x[(CTR_INDEX_WORD + 1) * CTR_LANES + lane] ^= (uint32_t)(index >> 32);
+        if (m != NULL)
+        {
+            for (w = 0; w < GIMLI_RATE / 4; ++w)
+            {
+                x[w * CTR_LANES + lane] ^=
+                    gimli_load(&m[lane * GIMLI_RATE + w * 4]);
+            }
+        }
+    }
+    ctr_permute_lanes(x);
+    for (lane = 0; lane < count; ++lane)
+    {
+        for (w = 0; w < GIMLI_RATE / 4; ++w)
+        {
+            rate[lane][w] = x[w * CTR_LANES + lane];
+        }
+    }
+}
+
+static void ctr_mac(uint32_t acc[GIMLI_RATE / 4], const gimli_ctr_state *s,
+                    uint32_t tag, const unsigned char *m, size_t len,
+                    uint64_t block)
+{
+    uint32_t rate[CTR_LANES][GIMLI_RATE / 4];
+    size_t lane;
+    unsigned w;
+    while (len >= GIMLI_RATE)
+    {
+        size_t count = len / GIMLI_RATE;
+        if (count > CTR_LANES)
+        {
+            count = CTR_LANES;
+        }
+        ctr_permute(rate, s, tag, block, m, count);
+        for (lane = 0; lane < count; ++lane)
+        {
+            for (w = 0; w < GIMLI_RATE / 4; ++w)
+            {
+                acc[w] ^= rate[lane][w];
+            }
+        }
+        m += count * GIMLI_RATE;
+        len -= count * GIMLI_RATE;
+        block += count;
+    }
+    if (len > 0)
+    {
+        /* The lengths in the final block make zero padding unambiguous. */
+        unsigned char last[GIMLI_RATE];
+        (void)memset(last, 0, sizeof last);
+        (void)memcpy(last, m, len);
+        ctr_permute(rate, s, tag, block, last, 1);
+        for (w = 0; w < GIMLI_RATE / 4; ++w)
+        {
+            acc[w] ^= rate[0][w];
+        }
+    }
+}
+
+void gimli_ctr_init(gimli_ctr_state *s,
+                    const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                    const unsigned char k[GIMLI_CTR_KEY_LEN])
+{
+    unsigned i;
+    for (i = 0; i < GIMLI_CTR_NONCE_LEN / 4; ++i)
+    {
+        s->base[i] = gimli_load(&n[i * 4]);
+    }
+    for (i = 0; i < GIMLI_CTR_KEY_LEN / 4; ++i)
+    {
+        s->base[GIMLI_CTR_NONCE_LEN / 4 + i] = gimli_load(&k[i * 4]);
+    }
+    gimli(s->base);
+}
+
+void gimli_ctr_xor(const gimli_ctr_state *s, unsigned char *out,
+                   const unsigned char *in, size_t len, uint64_t block)
+{
+    uint32_t rate[CTR_LANES][GIMLI_RATE / 4];
+    size_t lane;
+    unsigned w;
+    while (len > 0)
+    {
+        size_t count = (len + GIMLI_RATE - 1) / GIMLI_RATE;
+        if (count > CTR_LANES)
+        {
+            count = CTR_LANES;
+        }
+        ctr_permute(rate, s, GIMLI_TAG_CTR_STREAM, block, NULL, count);
+        block += count;
+        for (lane = 0; lane < count; ++lane)
+        {
+            if (len >= GIMLI_RATE)
+            {
+                for (w = 0; w < GIMLI_RATE / 4; ++w)
+                {
+                    gimli_store(&out[w * 4],
+                                gimli_load(&in[w * 4]) ^ rate[lane][w]);
+                }
+                out += GIMLI_RATE;
+                in += GIMLI_RATE;
+                len -= GIMLI_RATE;
+            }
+            else
+            {
+                unsigned char ks[GIMLI_RATE];
+                size_t i;
+                for (w = 0; w < GIMLI_RATE / 4; ++w)
+                {
+                    gimli_store(&ks[w * 4], rate[lane][w]);
+                }
+                for (i = 0; i < len; ++i)
+                {
+                    out[i] = in[i] ^ ks[i];
+                }
+                len = 0;
+            }
+        }
+    }
+}
+
+void gimli_ctr_mac_update(const gimli_ctr_state *s,
+                          unsigned char sum[GIMLI_CTR_TAG_LEN],
+                          const unsigned char *c, size_t len, uint64_t block)
+{
+    uint32_t acc[GIMLI_RATE / 4];
+    unsigned w;
+    for (w = 0; w < GIMLI_RATE / 4; ++w)
+    {
+        acc[w] = gimli_load(&sum[w * 4]);
+    }
+    ctr_mac(acc, s, GIMLI_TAG_CTR_MAC, c, len, block);
+    for (w = 0; w < GIMLI_RATE / 4; ++w)
+    {
+        gimli_store(&sum[w * 4], acc[w]);
+    }
+}
+
+void gimli_ctr_mac_final(const gimli_ctr_state *s,
+                         unsigned char t[GIMLI_CTR_TAG_LEN],
+                         const unsigned char sum[GIMLI_CTR_TAG_LEN],
+                         const unsigned char *ad, size_t adlen, uint64_t clen)
+{
+    uint32_t acc[GIMLI_RATE / 4];
+    uint32_t x[GIMLI_WORDS];
+    unsigned w;
+    for (w = 0; w < GIMLI_RATE / 4; ++w)
+    {
+        acc[w] = gimli_load(&sum[w * 4]);
+    }
+    ctr_mac(acc, s, GIMLI_TAG_CTR_AD, ad, adlen, 0);
+
+    (void)memcpy(x, s->base, sizeof x);
+    for (w = 0; w < GIMLI_RATE / 4; ++w)
+    {
+        x[w] ^= acc[w];
+    }
+    x[CTR_TAG_WORD] ^= GIMLI_TAG_CTR_FINAL;
+    x[CTR_ADLEN_WORD] ^= (uint32_t)adlen;
+    x[CTR_ADLEN_WORD + 1] ^= (uint32_t)((uint64_t)adlen >> 32);
+    x[CTR_CLEN_WORD] ^= (uint32_t)clen;
+    x[CTR_CLEN_WORD + 1] ^= (uint32_t)(clen >> 32);
+    gimli(x);
+    for (w = 0; w < GIMLI_CTR_TAG_LEN / 4; ++w)
+    {
+        gimli_store(&t[w * 4], x[w]);
+    }
+}
+
+void gimli_ctr_encrypt(unsigned char *c, unsigned char t[GIMLI_CTR_TAG_LEN],
+                       const unsigned char *m, size_t len,
+                       const unsigned char *ad, size_t adlen,
+                       const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                       const unsigned char k[GIMLI_CTR_KEY_LEN])
+{
+    gimli_ctr_state s;
+    unsigned char sum[GIMLI_CTR_TAG_LEN];
+    size_t done;
+    gimli_ctr_init(&s, n, k);
+    (void)memset(sum, 0, sizeof sum);
+    for (done = 0; done < len; done += CTR_SEGMENT_LEN)
+    {
+        const size_t seg =
+            (len - done < CTR_SEGMENT_LEN) ? len - done : CTR_SEGMENT_LEN;
+        const uint64_t block = done / GIMLI_RATE;
+        gimli_ctr_xor(&s, &c[done], &m[done], seg, block);
+        gimli_ctr_mac_update(&s, sum, &c[done], seg, block);
+    }
+    gimli_ctr_mac_final(&s, t, sum, ad, adlen, len);
+}
+
+bool gimli_ctr_decrypt(unsigned char *m, const unsigned char *c, size_t len,
+                       const unsigned char t[GIMLI_CTR_TAG_LEN],
+                       const unsigned char *ad, size_t adlen,
+                       const unsigned char n[GIMLI_CTR_NONCE_LEN],
+                       const unsigned char k[GIMLI_CTR_KEY_LEN])
+{
+    gimli_ctr_state s;
+    unsigned char sum[GIMLI_CTR_TAG_LEN], expected[GIMLI_CTR_TAG_LEN];
+    unsigned char mismatch = 0, mask;
+    bool success;
+    size_t done, i;
+    gimli_ctr_init(&s, n, k);
+    (void)memset(sum, 0, sizeof sum);
+    for (done = 0; done < len; done += CTR_SEGMENT_LEN)
+    {
+        const size_t seg =
+            (len - done < CTR_SEGMENT_LEN) ? len - done : CTR_SEGMENT_LEN;
+        const uint64_t block = done / GIMLI_RATE;
+        /* MAC the segment first, because m may be c. */
+        gimli_ctr_mac_update(&s, sum, &c[done], seg, block);
+        gimli_ctr_xor(&s, &m[done], &c[done], seg, block);
+    }
+    gimli_ctr_mac_final(&s, expected, sum, ad, adlen, len);
+    for (i = 0; i < GIMLI_CTR_TAG_LEN; ++i)
+    {
+        mismatch |= t[i] ^ expected[i];
+    }
+    success = mismatch == 0;
+    mask = (unsigned char)(~(unsigned int)success + 1);
+    for (i = 0; i < len; ++i)
+    {
+        m[i] &= mask;
+    }
+    return success;
+}
@@ -19,12 +19,47 @@ void gimli_hash_update(gimli_hash_state *g, const unsigned char *m, size_t len)
     gimli_absorb(g, m, len);
 }
 
+void gimli_hash_update_words(gimli_hash_state *g, const uint32_t *w,
+                             size_t nwords)
+{
+    gimli_absorb_words(g, w, nwords);
+}
+
+void gimli_hash_update_iov(gimli_hash_state *g, const lith_iovec *iov,
+                           size_t n)
+{
+    gimli_absorb_iov(g, iov, n);
+}
+
 void gimli_hash_final(gimli_hash_state *g, unsigned char *h, size_t len)
 {
     gimli_pad(g);
     gimli_squeeze(g, h, len);
 }
 
+void gimli_xof_init(gimli_hash_state *g)
+{
+    gimli_pad(g);
+    g->offset = GIMLI_RATE;
+}
+
+void gimli_xof_squeeze(gimli_hash_state *g, unsigned char *out, size_t len)
+{
+    gimli_squeeze_more(g, out, len);
+}
+
+void gimli_hash_export(const gimli_hash_state *g,
+                       unsigned char out[GIMLI_HASH_EXPORT_LEN])
+{
+    gimli_export(g, out, GIMLI_EXPORT_KIND_HASH, NULL, 0);
+}
+
+bool gimli_hash_import(gimli_hash_state *g,
+                       const unsigned char in[GIMLI_HASH_EXPORT_LEN])
+{
+    return gimli_import(g, in, GIMLI_EXPORT_KIND_HASH, NULL, 0);
+}
+
 void gimli_hash(unsigned char *h, size_t hlen, const unsigned char *m,
                 size_t mlen)
 {
@@ -33,3 +68,12 @@ void gimli_hash(unsigned char *h, size_t hlen, const unsigned char *m,
     gimli_hash_update(&g, m, mlen);
     gimli_hash_final(&g, h, hlen);
 }
+
+void gimli_hash_from(unsigned char *h, size_t hlen,
+                     const gimli_hash_state *prefix, const unsigned char *m,
+                     size_t mlen)
+{
+    gimli_state g = *prefix;
+    gimli_hash_update(&g, m, mlen);
+    gimli_hash_final(&g, h, hlen);
+}
@@ -0,0 +1,225 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+
+#include "gimli_common.h"
+#include "opt.h"
+
+#include <string.h>
+
+#if (LITH_VECTORIZE)
+
+/*
+ * Each lane hashes one message at a time. A lane absorbs a block of its
+ * message per step, then its padded last block, and then squeezes a block of
+ * output per step. When it has written all of its output, the lane is retired
+ * and refilled with the next message, so lanes with short messages don't wait
+ * for lanes with long ones.
+ */
+enum phase
+{
+    IDLE,
+    ABSORB,
+    SQUEEZE
+};
+
+/* The phase is last and padded, so that the struct has no implicit padding. */
+struct lane
+{
+    size_t msg;
+    size_t pos;
+    enum phase phase;
+    unsigned pad;
+};
+
+/*
+ * Continue the hash in a lane with the scalar permutation. This is cheaper
+ * than permuting every lane when only a few of them are still in use. A lane
+ * that is absorbing must have been permuted since its last input, and a lane
+ * that is squeezing must not have been permuted since its last output.
+ */
+static void finish_lane(unsigned char *const outs[], size_t out_len,
+                        const unsigned char *const msgs[], const size_t lens[],
+                        const uint32_t *s, const struct lane *l, size_t lane)
+{
+    gimli_hash_state g;
+    unsigned i;
+    for (i = 0; i < GIMLI_WORDS; ++i)
+    {
+        g.state[i] = s[i * GIMLI_X_LANES + lane];
+    }
+    if (l->phase == ABSORB)
+    {
+        g.offset = 0;
+        gimli_hash_update(&g, &msgs[l->msg][l->pos], lens[l->msg] - l->pos);
+        gimli_hash_final(&g, outs[l->msg], out_len);
+    }
+    else
+    {
+        /*
+         * A whole block was just output and the state has not been permuted
+         * since, so the next output starts with a permutation.
+         */
+        g.offset = GIMLI_RATE;
+        gimli_squeeze_more(&g, &outs[l->msg][l->pos], out_len - l->pos);
+    }
+}
+
+static void hash_lanes(unsigned char *const outs[], size_t out_len,
+                       const gimli_state *init,
+                       const unsigned char *const msgs[], const size_t lens[],
+                       size_t n)
+{
+    uint32_t s[GIMLI_WORDS * GIMLI_X_LANES];
+    struct lane lanes[GIMLI_X_LANES];
+    size_t next = 0, lane;
+    unsigned i;
+
+    for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+    {
+        lanes[lane].phase = IDLE;
+    }
+
+    for (;;)
+    {
+        size_t active = 0;
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            struct lane *const l = &lanes[lane];
+            if ((l->phase == IDLE) && (next < n))
+            {
+                l->phase = ABSORB;
+                l->msg = next++;
+                l->pos = 0;
+                for (i = 0; i < GIMLI_WORDS; ++i)
+                {
+                    s[i * GIMLI_X_LANES + lane] = init->state[i];
+                }
+            }
+            if (l->phase != IDLE)
+            {
+                ++active;
+            }
+        }
+
+        if (active == 0)
+        {
+            return;
+        }
+        if ((next == n) && (active * 4 <= GIMLI_X_LANES))
+        {
+            break;
+        }
+
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            struct lane *const l = &lanes[lane];
+            if (l->phase == ABSORB)
+            {
+                const unsigned char *const m = &msgs[l->msg][l->pos];
+                const size_t left = lens[l->msg] - l->pos;
+                if (left >= GIMLI_RATE)
+                {
+                    for (i = 0; i < GIMLI_RATE / 4; ++i)
+                    {
+                        s[i * GIMLI_X_LANES + lane] ^= gimli_load(&m[i * 4]);
+                    }
+                    l->pos += GIMLI_RATE;
+                }
+                else
+                {
+                    unsigned char last[GIMLI_RATE];
+                    (void)memset(last, 0, sizeof last);
+                    (void)memcpy(last, m, left);
+                    last[left] = 0x01;
+                    for (i = 0; i < GIMLI_RATE / 4; ++i)
+                    {
+                        s[i * GIMLI_X_LANES + lane] ^= gimli_load(&last[i * 4]);
+                    }
+                    s[(GIMLI_WORDS - 1) * GIMLI_X_LANES + lane] ^=
+                        UINT32_C(0x01000000);
+                    l->phase = SQUEEZE;
+                    l->pos = 0;
+                }
+            }
+        }
+
+        gimli_x_lanes(s);
+
+        for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+        {
+            struct lane *const l = &lanes[lane];
+            if (l->phase == SQUEEZE)
+            {
+                unsigned char block[GIMLI_RATE];
+                size_t len = out_len - l->pos;
+                if (len > GIMLI_RATE)
+                {
+                    len = GIMLI_RATE;
+                }
+                for (i = 0; i < GIMLI_RATE / 4; ++i)
+                {
+                    gimli_store(&block[i * 4], s[i * GIMLI_X_LANES + lane]);
+                }
+                (void)memcpy(&outs[l->msg][l->pos], block, len);
+                l->pos += len;
+                if (l->pos == out_len)
+                {
+                    l->phase = IDLE;
+                }
+            }
+        }
+    }
+
+    for (lane = 0; lane < GIMLI_X_LANES; ++lane)
+    {
+        if (lanes[lane].phase != IDLE)
+        {
+            finish_lane(outs, out_len, msgs, lens, s, &lanes[lane], lane);
+        }
+    }
+}
+
+#endif /* LITH_VECTORIZE */
+
+void gimli_hash_many_from(unsigned char *const outs[], size_t out_len,
+                          const gimli_state *init,
+                          const unsigned char *const msgs[],
+                          const size_t lens[], size_t n)
+{
+#if (LITH_VECTORIZE)
+    hash_lanes(outs, out_len, init, msgs, lens, n);
+#else
+    size_t i;
+    /*
+     * Without vector units there is no wider permutation to share, so hash
+     * each message in turn. Interleaving two scalar states gains nothing
+     * either, because the scalar permutation already keeps the ALUs busy.
+     */
+    for (i = 0; i < n; ++i)
+    {
+        gimli_hash_state g = *init;
+        gimli_hash_update(&g, msgs[i], lens[i]);
+        gimli_hash_final(&g, outs[i], out_len);
+    }
+#endif
+}
+
+void gimli_hash_many_tagged(unsigned char *const outs[], size_t out_len,
+                            const unsigned char *const msgs[],
+                            const size_t lens[], size_t n, uint32_t tag)
+{
+    gimli_state init;
+    gimli_init_tagged(&init, tag);
+    gimli_hash_many_from(outs, out_len, &init, msgs, lens, n);
+}
+
+void gimli_hash_many(unsigned char *const outs[], size_t out_len,
+                     const unsigned char *const msgs[], const size_t lens[],
+                     size_t n)
+{
+    gimli_hash_many_tagged(outs, out_len, msgs, lens, n, 0);
+}
@@ -0,0 +1,158 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_short_hash.h>
+
+#include <lithium/gimli.h>
+
+#include "gimli_common.h"
+
+/* The 64-bit outputs of the batched hash are collected in batches. */
+#define SHORT_BATCH 64U
+
+/*
+ * The initial state is the domain tag in the first capacity word, followed by
+ * the key. The rest of the hash is Gimli-Hash, so the batched form can use the
+ * lanes of gimli_hash_many.
+ */
+static void short_init(gimli_state *g, uint32_t tag,
+                       const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    unsigned i;
+    gimli_init_tagged(g, tag);
+    for (i = 0; i < GIMLI_SHORT_HASH_KEY_LEN / 4; ++i)
+    {
+        g->state[GIMLI_RATE / 4 + 1 + i] = gimli_load(&key[i * 4]);
+    }
+}
+
+/* Absorb a whole block and permute. */
+static void short_block(uint32_t state[GIMLI_WORDS], const unsigned char *m)
+{
+    state[0] ^= gimli_load(&m[0]);
+    state[1] ^= gimli_load(&m[4]);
+    state[2] ^= gimli_load(&m[8]);
+    state[3] ^= gimli_load(&m[12]);
+    gimli(state);
+}
+
+/*
+ * Absorb the last len < GIMLI_RATE bytes with their padding and permute. The
+ * whole words are loaded directly, and the padding byte is shifted in above
+ * the bytes of the partial word, so nothing is copied.
+ */
+static void short_last(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                       size_t len)
+{
+    const size_t words = len / 4;
+    uint32_t tail = 0x01;
+    size_t i;
+    for (i = 0; i < words; ++i)
+    {
+        state[i] ^= gimli_load(&m[i * 4]);
+    }
+    for (i = len; i > words * 4; --i)
+    {
+        tail = (tail << 8) | m[i - 1];
+    }
+    state[words] ^= tail;
+    state[GIMLI_WORDS - 1] ^= UINT32_C(0x01000000);
+    gimli(state);
+}
+
+/*
+ * Absorb the whole padded input and permute. The rate is always empty at the
+ * start, so the input is absorbed in place without the incremental sponge.
+ * Inputs shorter than 48 bytes, which have at most two whole blocks, take a
+ * straight sequence of calls rather than the loop.
+ */
+static void short_absorb(uint32_t state[GIMLI_WORDS], const unsigned char *m,
+                         size_t len)
+{
+    if (len < 3 * GIMLI_RATE)
+    {
+        if (len >= GIMLI_RATE)
+        {
+            short_block(state, m);
+            m += GIMLI_RATE;
+            len -= GIMLI_RATE;
+        }
+        if (len >= GIMLI_RATE)
+        {
+            short_block(state, m);
+            m += GIMLI_RATE;
+            len -= GIMLI_RATE;
+        }
+    }
+    else
+    {
+        for (; len >= GIMLI_RATE; m += GIMLI_RATE, len -= GIMLI_RATE)
+        {
+            short_block(state, m);
+        }
+    }
+    short_last(state, m, len);
+}
+
+uint64_t gimli_short_hash64(const unsigned char *m, size_t len,
+                            const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    gimli_state g;
+    short_init(&g, GIMLI_TAG_SHORT_HASH_64, key);
+    short_absorb(g.state, m, len);
+    /* The first 8 bytes of output, in little-endian order. */
+    return ((uint64_t)g.state[1] << 32) | g.state[0];
+}
+
+void gimli_short_hash128(unsigned char h[GIMLI_SHORT_HASH_128_LEN],
+                         const unsigned char *m, size_t len,
+                         const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    gimli_state g;
+    unsigned i;
+    short_init(&g, GIMLI_TAG_SHORT_HASH_128, key);
+    short_absorb(g.state, m, len);
+    for (i = 0; i < GIMLI_SHORT_HASH_128_LEN / 4; ++i)
+    {
+        gimli_store(&h[i * 4], g.state[i]);
+    }
+}
+
+void gimli_short_hash64_many(uint64_t h[], const unsigned char *const msgs[],
+                             const size_t lens[], size_t n,
+                             const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    unsigned char out[SHORT_BATCH][8];
+    unsigned char *outs[SHORT_BATCH];
+    gimli_state init;
+    size_t i, j;
+
+    short_init(&init, GIMLI_TAG_SHORT_HASH_64, key);
+    for (j = 0; j < SHORT_BATCH; ++j)
+    {
+        outs[j] = out[j];
+    }
+    for (i = 0; i < n; i += SHORT_BATCH)
+    {
+        const size_t batch = (n - i < SHORT_BATCH) ? n - i : SHORT_BATCH;
+        gimli_hash_many_from(outs, sizeof out[0], &init, &msgs[i], &lens[i],
+                             batch);
+        for (j = 0; j < batch; ++j)
+        {
+            h[i + j] = ((uint64_t)gimli_load(&out[j][4]) << 32) |
+                       gimli_load(&out[j][0]);
+        }
+    }
+}
+
+void gimli_short_hash128_many(
+    unsigned char *const outs[], const unsigned char *const msgs[],
+    const size_t lens[], size_t n,
+    const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    gimli_state init;
+    short_init(&init, GIMLI_TAG_SHORT_HASH_128, key);
+    gimli_hash_many_from(outs, GIMLI_SHORT_HASH_128_LEN, &init, msgs, lens, n);
+}
@@ -0,0 +1,109 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_stream.h>
+
+#include "gimli_common.h"
+#include "memzero.h"
+
+#include <string.h>
+
+static void chunk_nonce(unsigned char n[GIMLI_AEAD_NONCE_LEN],
+                        const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+                        uint32_t index, bool last)
+{
+    (void)memcpy(n, prefix, GIMLI_STREAM_PREFIX_LEN);
+    gimli_store(&n[GIMLI_STREAM_PREFIX_LEN], index);
+    n[GIMLI_STREAM_PREFIX_LEN + 4] = last ? 1 : 0;
+}
+
+void gimli_stream_encrypt_chunk(
+    unsigned char *c, unsigned char t[GIMLI_STREAM_TAG_LEN],
+    const unsigned char *m, size_t len, uint32_t index, bool last,
+    const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+    const unsigned char key[GIMLI_STREAM_KEY_LEN])
+{
+    unsigned char n[GIMLI_AEAD_NONCE_LEN];
+    chunk_nonce(n, prefix, index, last);
+    gimli_aead_encrypt(c, t, GIMLI_STREAM_TAG_LEN, m, len, NULL, 0, n, key);
+}
+
+bool gimli_stream_decrypt_chunk(
+    unsigned char *m, const unsigned char *c, size_t len,
+    const unsigned char t[GIMLI_STREAM_TAG_LEN], uint32_t index, bool last,
+    const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+    const unsigned char key[GIMLI_STREAM_KEY_LEN])
+{
+    unsigned char n[GIMLI_AEAD_NONCE_LEN];
+    chunk_nonce(n, prefix, index, last);
+    return gimli_aead_decrypt(m, c, len, t, GIMLI_STREAM_TAG_LEN, NULL, 0, n,
+                              key);
+}
+
+void gimli_stream_init(gimli_stream_state *s,
+                       const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN],
+                       const unsigned char key[GIMLI_STREAM_KEY_LEN])
+{
+    (void)memcpy(s->prefix, prefix, GIMLI_STREAM_PREFIX_LEN);
+    (void)memcpy(s->key, key, GIMLI_STREAM_KEY_LEN);
+    s->index = 0;
+    s->done = false;
+}
+
+/*
+ * Whether there is a next chunk. Only the last chunk may have the largest
+ * index.
+ */
+static bool has_next(const gimli_stream_state *s, bool last)
+{
+    return !s->done && (last || (s->index < UINT32_MAX));
+}
+
+/* Move to the next chunk, or end the stream and clear the key. */
+static void next(gimli_stream_state *s, bool end)
+{
+    if (end)
+    {
+        s->done = true;
+        lith_memzero(s->key, sizeof s->key);
+    }
+    else
+    {
+        ++s->index;
+    }
+}
+
+bool gimli_stream_encrypt_next(gimli_stream_state *s, unsigned char *c,
+                               unsigned char t[GIMLI_STREAM_TAG_LEN],
+                               const unsigned char *m, size_t len, bool last)
+{
+    if (!has_next(s, last))
+    {
+        return false;
+    }
+    gimli_stream_encrypt_chunk(c, t, m, len, s->index, last, s->prefix,
+                               s->key);
+    next(s, last);
+    return true;
+}
+
+bool gimli_stream_decrypt_next(gimli_stream_state *s, unsigned char *m,
+                               const unsigned char *c, size_t len,
+                               const unsigned char t[GIMLI_STREAM_TAG_LEN],
+                               bool last)
+{
+    bool ok = false;
+    if (has_next(s, last))
+    {
+        ok = gimli_stream_decrypt_chunk(m, c, len, t, s->index, last,
+                                        s->prefix, s->key);
+        next(s, last || !ok);
+    }
+    else if (len > 0)
+    {
+        (void)memset(m, 0, len);
+    }
+    return ok;
+}
@@ -0,0 +1,196 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_strobe.h>
+
+#include "gimli_common.h"
+
+/*
+ * The operation flags of STROBE: inbound, application, cipher, transport, and
+ * meta. Each operation is a combination of these.
+ */
+#define STROBE_FLAG_I 0x01U
+#define STROBE_FLAG_A 0x02U
+#define STROBE_FLAG_C 0x04U
+#define STROBE_FLAG_T 0x08U
+#define STROBE_FLAG_M 0x10U
+
+#define STROBE_AD STROBE_FLAG_A
+#define STROBE_KEY (STROBE_FLAG_A | STROBE_FLAG_C)
+#define STROBE_PRF (STROBE_FLAG_I | STROBE_FLAG_A | STROBE_FLAG_C)
+#define STROBE_SEND_ENC (STROBE_FLAG_A | STROBE_FLAG_C | STROBE_FLAG_T)
+#define STROBE_RECV_ENC (STROBE_FLAG_I | STROBE_SEND_ENC)
+#define STROBE_SEND_MAC (STROBE_FLAG_C | STROBE_FLAG_T)
+#define STROBE_RECV_MAC (STROBE_FLAG_I | STROBE_SEND_MAC)
+
+/* The last two bytes of the rate are reserved for the padding. */
+#define STROBE_RATE (GIMLI_RATE - 2U)
+
+#define STROBE_ROLE_NONE 0xFFU
+
+/*
+ * Pad and permute. The padding records where the current operation began in
+ * the block, so that the framing can be parsed back from the transcript.
+ */
+static void strobe_permute(gimli_strobe_state *s)
+{
+    gimli_state *const g = &s->g;
+    gimli_absorb_byte(g, s->pos_begin);
+    ++g->offset;
+    gimli_absorb_byte(g, 0x04);
+    g->offset = STROBE_RATE + 1;
+    gimli_absorb_byte(g, 0x80);
+#if (LITH_ENABLE_WATCHDOG)
+    lith_watchdog_pet();
+#endif
+    gimli(g->state);
+    g->offset = 0;
+    s->pos_begin = 0;
+}
+
+/*
+ * Run len bytes of in through the duplex, or zeros if in is NULL. With
+ * cbefore, each byte is XORed with the state before it is absorbed, and with
+ * cafter, the output is the state after the byte is absorbed. out may be NULL
+ * or in.
+ */
+static void strobe_duplex(gimli_strobe_state *s, unsigned char *out,
+                          const unsigned char *in, size_t len, bool cbefore,
+                          bool cafter)
+{
+    gimli_state *const g = &s->g;
+    size_t i;
+    for (i = 0; i < len; ++i)
+    {
+        unsigned char b = (in != NULL) ? in[i] : 0;
+        if (cbefore)
+        {
+            b ^= gimli_squeeze_byte(g);
+        }
+        gimli_absorb_byte(g, b);
+        if (cafter)
+        {
+            b = gimli_squeeze_byte(g);
+        }
+        if (out != NULL)
+        {
+            out[i] = b;
+        }
+        ++g->offset;
+        if (g->offset == STROBE_RATE)
+        {
+            strobe_permute(s);
+        }
+    }
+}
+
+static void strobe_begin(gimli_strobe_state *s, unsigned flags)
+{
+    unsigned char header[2];
+    if ((flags & STROBE_FLAG_T) != 0)
+    {
+        /* Both parties absorb the flags as seen by the initiator. */
+        if (s->initiator == STROBE_ROLE_NONE)
+        {
+            s->initiator = (unsigned char)(flags & STROBE_FLAG_I);
+        }
+        flags ^= s->initiator;
+    }
+    header[0] = s->pos_begin;
+    header[1] = (unsigned char)flags;
+    s->pos_begin = (unsigned char)(s->g.offset + 1);
+    strobe_duplex(s, NULL, header, sizeof header, false, false);
+    if (((flags & STROBE_FLAG_C) != 0) && (s->g.offset != 0))
+    {
+        strobe_permute(s);
+    }
+}
+
+static void strobe_operate(gimli_strobe_state *s, unsigned flags,
+                           unsigned char *out, const unsigned char *in,
+                           size_t len, bool more)
+{
+    const bool cafter =
+        (flags & (STROBE_FLAG_C | STROBE_FLAG_I | STROBE_FLAG_T)) ==
+        (STROBE_FLAG_C | STROBE_FLAG_T);
+    const bool cbefore = ((flags & STROBE_FLAG_C) != 0) && !cafter;
+    /* A continuation of a different operation starts a new one. */
+    if (!more || (s->flags != flags))
+    {
+        strobe_begin(s, flags);
+        s->flags = (unsigned char)flags;
+    }
+    strobe_duplex(s, out, in, len, cbefore, cafter);
+}
+
+void gimli_strobe_init(gimli_strobe_state *s, const unsigned char *proto,
+                       size_t len)
+{
+    gimli_init_tagged(&s->g, GIMLI_TAG_STROBE);
+    s->pos_begin = 0;
+    s->flags = 0;
+    s->initiator = STROBE_ROLE_NONE;
+    s->pad = 0;
+    strobe_operate(s, STROBE_FLAG_A | STROBE_FLAG_M, NULL, proto, len, false);
+}
+
+void gimli_strobe_ad(gimli_strobe_state *s, const unsigned char *ad,
+                     size_t len, bool more)
+{
+    strobe_operate(s, STROBE_AD, NULL, ad, len, more);
+}
+
+void gimli_strobe_key(gimli_strobe_state *s, const unsigned char *key,
+                      size_t len)
+{
+    strobe_operate(s, STROBE_KEY, NULL, key, len, false);
+}
+
+void gimli_strobe_send_enc(gimli_strobe_state *s, unsigned char *c,
+                           const unsigned char *m, size_t len, bool more)
+{
+    strobe_operate(s, STROBE_SEND_ENC, c, m, len, more);
+}
+
+void gimli_strobe_recv_enc(gimli_strobe_state *s, unsigned char *m,
+                           const unsigned char *c, size_t len, bool more)
+{
+    strobe_operate(s, STROBE_RECV_ENC, m, c, len, more);
+}
+
+void gimli_strobe_send_mac(gimli_strobe_state *s, unsigned char *t,
+                           size_t len)
+{
+    strobe_operate(s, STROBE_SEND_MAC, t, NULL, len, false);
+}
+
+bool gimli_strobe_recv_mac(gimli_strobe_state *s, const unsigned char *t,
+                           size_t len)
+{
+    unsigned char diff[GIMLI_RATE];
+    unsigned char mismatch = 0;
+    bool more = false;
+    size_t i;
+    /* The received MAC XORed with the expected one must be all zeros. */
+    do
+    {
+        const size_t n = (len < sizeof diff) ? len : sizeof diff;
+        strobe_operate(s, STROBE_RECV_MAC, diff, t, n, more);
+        for (i = 0; i < n; ++i)
+        {
+            mismatch |= diff[i];
+        }
+        t += n;
+        len -= n;
+        more = true;
+    } while (len > 0);
+    return mismatch == 0;
+}
+
+void gimli_strobe_prf(gimli_strobe_state *s, unsigned char *out, size_t len,
+                      bool more)
+{
+    strobe_operate(s, STROBE_PRF, out, NULL, len, more);
+}
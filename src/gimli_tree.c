@@ -0,0 +1,170 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_tree.h>
+
+#include <lithium/gimli_hash.h>
+
+#include "gimli_common.h"
+
+#include <string.h>
+
+/* Whole leaves are hashed in batches that fill the widest lanes. */
+#define BATCH 16U
+
+static void leaf_init(gimli_tree_state *g)
+{
+    gimli_init_tagged(&g->leaf, GIMLI_TAG_TREE_LEAF);
+    g->leaf_len = 0;
+}
+
+void gimli_tree_init(gimli_tree_state *g)
+{
+    leaf_init(g);
+    g->leaves = 0;
+    g->depth = 0;
+}
+
+void gimli_tree_leaf(unsigned char h[GIMLI_TREE_HASH_LEN],
+                     const unsigned char *m, size_t len)
+{
+    gimli_hash_state s;
+    gimli_init_tagged(&s, GIMLI_TAG_TREE_LEAF);
+    gimli_hash_update(&s, m, len);
+    gimli_hash_final(&s, h, GIMLI_TREE_HASH_LEN);
+}
+
+void gimli_tree_parent(unsigned char h[GIMLI_TREE_HASH_LEN],
+                       const unsigned char left[GIMLI_TREE_HASH_LEN],
+                       const unsigned char right[GIMLI_TREE_HASH_LEN])
+{
+    /* h may alias left or right, as both are absorbed before h is written. */
+    gimli_hash_state s;
+    gimli_init_tagged(&s, GIMLI_TAG_TREE_PARENT);
+    gimli_hash_update(&s, left, GIMLI_TREE_HASH_LEN);
+    gimli_hash_update(&s, right, GIMLI_TREE_HASH_LEN);
+    gimli_hash_final(&s, h, GIMLI_TREE_HASH_LEN);
+}
+
+/*
+ * Push the root of a subtree of leaves leaves, and then merge the top two
+ * subtrees while they are the same size, like carries in a binary counter.
+ */
+static void push(gimli_tree_state *g,
+                 const unsigned char h[GIMLI_TREE_HASH_LEN], uint64_t leaves)
+{
+    (void)memcpy(g->stack[g->depth], h, GIMLI_TREE_HASH_LEN);
+    ++g->depth;
+    g->leaves += leaves;
+    while ((g->depth >= 2) && ((g->leaves % (leaves * 2)) == 0))
+    {
+        gimli_tree_parent(g->stack[g->depth - 2], g->stack[g->depth - 2],
+                          g->stack[g->depth - 1]);
+        --g->depth;
+        leaves *= 2;
+    }
+}
+
+static void finish_leaf(gimli_tree_state *g)
+{
+    unsigned char h[GIMLI_TREE_HASH_LEN];
+    gimli_hash_final(&g->leaf, h, sizeof h);
+    push(g, h, 1);
+    leaf_init(g);
+}
+
+void gimli_tree_update(gimli_tree_state *g, const unsigned char *m,
+                       size_t len)
+{
+    while (len > 0)
+    {
+        if ((g->leaf_len == 0) && (len >= GIMLI_TREE_LEAF_LEN))
+        {
+            unsigned char hs[BATCH][GIMLI_TREE_HASH_LEN];
+            unsigned char *outs[BATCH];
+            const unsigned char *msgs[BATCH];
+            size_t lens[BATCH];
+            size_t n = len / GIMLI_TREE_LEAF_LEN, i;
+            if (n > BATCH)
+            {
+                n = BATCH;
+            }
+            for (i = 0; i < n; ++i)
+            {
+                outs[i] = hs[i];
+                msgs[i] = &m[i * GIMLI_TREE_LEAF_LEN];
+                lens[i] = GIMLI_TREE_LEAF_LEN;
+            }
+            gimli_hash_many_tagged(outs, GIMLI_TREE_HASH_LEN, msgs, lens, n,
+                                   GIMLI_TAG_TREE_LEAF);
+            for (i = 0; i < n; ++i)
+            {
+                push(g, hs[i], 1);
+            }
+            m += n * GIMLI_TREE_LEAF_LEN;
+            len -= n * GIMLI_TREE_LEAF_LEN;
+        }
+        else
+        {
+            size_t take = GIMLI_TREE_LEAF_LEN - g->leaf_len;
+            if (take > len)
+            {
+                take = len;
+            }
+            gimli_hash_update(&g->leaf, m, take);
+            g->leaf_len += take;
+            m += take;
+            len -= take;
+            if (g->leaf_len == GIMLI_TREE_LEAF_LEN)
+            {
+                finish_leaf(g);
+            }
+        }
+    }
+}
+
+bool gimli_tree_update_subtree(gimli_tree_state *g,
+                               const unsigned char root[GIMLI_TREE_HASH_LEN],
+                               uint64_t leaves)
+{
+    /*
+     * A subtree that is not a power of two, or not aligned to its size, would
+     * never merge, and the stack would overflow. A pending partial leaf would
+     * be hashed after the subtree.
+     */
+    if ((leaves == 0) || ((leaves & (leaves - 1)) != 0) ||
+        (g->leaf_len != 0) || ((g->leaves % leaves) != 0) ||
+        (g->leaves > UINT64_MAX - leaves))
+    {
+        return false;
+    }
+    push(g, root, leaves);
+    return true;
+}
+
+void gimli_tree_final(gimli_tree_state *g,
+                      unsigned char root[GIMLI_TREE_HASH_LEN])
+{
+    unsigned i;
+    if ((g->leaf_len > 0) || (g->leaves == 0))
+    {
+        finish_leaf(g);
+    }
+    /* Join the remaining subtrees from right to left. */
+    (void)memcpy(root, g->stack[g->depth - 1], GIMLI_TREE_HASH_LEN);
+    for (i = g->depth - 1; i > 0; --i)
+    {
+        gimli_tree_parent(root, g->stack[i - 1], root);
+    }
+}
+
+void gimli_tree_hash(unsigned char root[GIMLI_TREE_HASH_LEN],
+                     const unsigned char *m, size_t len)
+{
+    gimli_tree_state g;
+    gimli_tree_init(&g);
+    gimli_tree_update(&g, m, len);
+    gimli_tree_final(&g, root);
+}
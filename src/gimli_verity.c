@@ -0,0 +1,214 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_verity.h>
+
+#include "gimli_common.h"
+
+#include <string.h>
+
+#define HASH_LEN GIMLI_TREE_HASH_LEN
+
+/* Nodes are hashed in batches that fill the widest lanes. */
+#define VERITY_BATCH 16U
+
+/* The number of nodes on the level above a level of n nodes. */
+static uint64_t level_above(uint64_t n)
+{
+    return (n / 2) + (n % 2);
+}
+
+uint64_t gimli_verity_blocks(uint64_t len)
+{
+    const uint64_t blocks = (len / GIMLI_TREE_LEAF_LEN) +
+                            ((len % GIMLI_TREE_LEAF_LEN) != 0);
+    /* An empty image is a single empty block, as in gimli_tree_hash. */
+    return (blocks == 0) ? 1 : blocks;
+}
+
+uint64_t gimli_verity_nodes(uint64_t blocks)
+{
+    uint64_t nodes = blocks;
+    while (blocks > 1)
+    {
+        blocks = level_above(blocks);
+        nodes += blocks;
+    }
+    return nodes;
+}
+
+/*
+ * Hash n nodes, whose inputs are consecutive runs of stride bytes of in, and
+ * the last of which may be shorter.
+ */
+static void hash_nodes(unsigned char *out, const unsigned char *in,
+                       size_t in_len, size_t stride, size_t n, uint32_t tag)
+{
+    size_t i, j;
+    for (i = 0; i < n; i += VERITY_BATCH)
+    {
+        unsigned char *outs[VERITY_BATCH];
+        const unsigned char *msgs[VERITY_BATCH];
+        size_t lens[VERITY_BATCH];
+        size_t batch = n - i;
+        if (batch > VERITY_BATCH)
+        {
+            batch = VERITY_BATCH;
+        }
+        for (j = 0; j < batch; ++j)
+        {
+            const size_t pos = (i + j) * stride;
+            outs[j] = &out[(i + j) * HASH_LEN];
+            msgs[j] = &in[pos];
+            lens[j] = ((in_len - pos) < stride) ? in_len - pos : stride;
+        }
+        gimli_hash_many_tagged(outs, HASH_LEN, msgs, lens, batch, tag);
+    }
+}
+
+void gimli_verity_build(unsigned char *nodes,
+                        unsigned char root[GIMLI_TREE_HASH_LEN],
+                        const unsigned char *image, size_t len)
+{
+    size_t n = (size_t)gimli_verity_blocks(len);
+    unsigned char *level = nodes;
+
+    hash_nodes(level, image, len, GIMLI_TREE_LEAF_LEN, n,
+               GIMLI_TAG_TREE_LEAF);
+    while (n > 1)
+    {
+        unsigned char *const above = &level[n * HASH_LEN];
+        /*
+         * A parent hashes the concatenation of its children, which are
+         * adjacent on the level below.
+         */
+        hash_nodes(above, level, (n / 2) * 2 * HASH_LEN, 2 * HASH_LEN, n / 2,
+                   GIMLI_TAG_TREE_PARENT);
+        if ((n % 2) != 0)
+        {
+            (void)memcpy(&above[(n / 2) * HASH_LEN], &level[(n - 1) * HASH_LEN],
+                         HASH_LEN);
+        }
+        level = above;
+        n = (size_t)level_above(n);
+    }
+    (void)memcpy(root, level, HASH_LEN);
+}
+
+void gimli_verity_init(gimli_verity_state *v,
+                       const unsigned char root[GIMLI_TREE_HASH_LEN],
+                       const unsigned char *nodes, uint64_t blocks,
+                       unsigned char *verified)
+{
+    (void)memcpy(v->root, root, HASH_LEN);
+    v->nodes = nodes;
+    v->blocks = blocks;
+    v->verified = verified;
+}
+
+static bool is_verified(const gimli_verity_state *v, uint64_t node)
+{
+    return (v->verified != NULL) &&
+           (((v->verified[node / 8] >> (node % 8)) & 1U) != 0);
+}
+
+static void set_verified(gimli_verity_state *v, uint64_t node)
+{
+    v->verified[node / 8] =
+        (unsigned char)(v->verified[node / 8] | (1U << (node % 8)));
+}
+
+static bool node_equal(const gimli_verity_state *v, uint64_t node,
+                       const unsigned char h[HASH_LEN])
+{
+    return memcmp(&v->nodes[(size_t)node * HASH_LEN], h, HASH_LEN) == 0;
+}
+
+/*
+ * Once a node is verified, the stored nodes that were hashed to produce it
+ * are also correct. Mark the path from the block up to and including the
+ * node at level top, and the siblings that were hashed along the way.
+ */
+static void mark_path(gimli_verity_state *v, uint64_t index, unsigned top)
+{
+    uint64_t n = v->blocks, offset = 0, i = index;
+    unsigned level;
+    for (level = 0;; ++level)
+    {
+        set_verified(v, offset + i);
+        if (level == top)
+        {
+            return;
+        }
+        if ((i ^ 1) < n)
+        {
+            set_verified(v, offset + (i ^ 1));
+        }
+        offset += n;
+        n = level_above(n);
+        i /= 2;
+    }
+}
+
+bool gimli_verity_verify_block(gimli_verity_state *v, uint64_t index,
+                               const unsigned char *block, size_t len)
+{
+    unsigned char h[HASH_LEN];
+    uint64_t n = v->blocks, offset = 0, i = index;
+    unsigned level;
+
+    if ((index >= v->blocks) || (len > GIMLI_TREE_LEAF_LEN))
+    {
+        return false;
+    }
+
+    gimli_tree_leaf(h, block, len);
+    for (level = 0;; ++level)
+    {
+        /*
+         * The stored node must match the hash computed from the block, so
+         * that it can be marked as verified if the path checks out.
+         */
+        if (!node_equal(v, offset + i, h))
+        {
+            return false;
+        }
+        if (is_verified(v, offset + i))
+        {
+            break;
+        }
+        if (n == 1)
+        {
+            if (memcmp(h, v->root, HASH_LEN) != 0)
+            {
+                return false;
+            }
+            break;
+        }
+        if ((i ^ 1) < n)
+        {
+            const unsigned char *const sibling =
+                &v->nodes[(size_t)(offset + (i ^ 1)) * HASH_LEN];
+            if ((i % 2) == 0)
+            {
+                gimli_tree_parent(h, h, sibling);
+            }
+            else
+            {
+                gimli_tree_parent(h, sibling, h);
+            }
+        }
+        /* Otherwise, the last node of an odd level is repeated above. */
+        offset += n;
+        n = level_above(n);
+        i /= 2;
+    }
+
+    if (v->verified != NULL)
+    {
+        mark_path(v, index, level);
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Must come first so that the entry points are renamed for dispatch. */
+#include "dispatch.h"
+
+#include <lithium/gimli.h>
+
+#include "opt.h"
+
+/*
+ * The multi-state permutations use an interleaved layout, where word w of
+ * state l is at state[w * lanes + l]. Each Gimli state word then occupies one
+ * vector, and the small and big swaps become renames of whole vectors instead
+ * of lane shuffles.
+ */
+
+#if (LITH_VECTORIZE)
+
+/*
+ * The helpers are named differently from those in gimli.c, so that both files
+ * can be included in the amalgamation, lithium.c.
+ */
+static uint32_t lanes_coeff(int round)
+{
+    return UINT32_C(0x9E377900) | (uint32_t)round;
+}
+
+#define rol(x, n) (((x) << ((n) % 32)) | ((x) >> ((32 - (n)) % 32)))
+
+#define LANES_SP_BOX(s, column)                                                \
+    do                                                                         \
+    {                                                                          \
+        const __typeof__(s[0]) x = rol(s[column], 24);                         \
+        const __typeof__(s[0]) y = rol(s[(column) + 4], 9);                    \
+        const __typeof__(s[0]) z = s[(column) + 8];                            \
+        s[(column) + 8] = x ^ (z << 1) ^ ((y & z) << 2);                       \
+        s[(column) + 4] = y ^ x ^ ((x | z) << 1);                              \
+        s[column] = z ^ y ^ ((x & y) << 3);                                    \
+    } while (0)
+
+#define LANES_SP_BOXES(s)                                                      \
+    do                                                                         \
+    {                                                                          \
+        LANES_SP_BOX(s, 0);                                                    \
+        LANES_SP_BOX(s, 1);                                                    \
+        LANES_SP_BOX(s, 2);                                                    \
+        LANES_SP_BOX(s, 3);                                                    \
+    } while (0)
+
+#define SWAP(a, b)                                                             \
+    do                                                                         \
+    {                                                                          \
+        const __typeof__(a) tmp = (a);                                         \
+        (a) = (b);                                                             \
+        (b) = tmp;                                                             \
+    } while (0)
+
+/*
+ * Vectors wider than the target supports are split by the compiler, so e.g.,
+ * gimli_x8 uses two 128-bit vectors per word on SSE2 and Neon and one 256-bit
+ * vector on AVX2, and gimli_x16 fills a 512-bit vector on AVX-512. With
+ * AVX-512VL, the compiler implements the rotates with vprold and the
+ * three-input XORs of the SP-box with vpternlogd, for both the single-state
+ * and multi-state permutations, so there is no separate AVX-512 kernel.
+ *
+ * The rounds are unrolled in groups of four so that the swaps are renames
+ * rather than data movement.
+ */
+#define GIMLI_LANES(name, lanes)                                               \
+    typedef uint32_t name##_vec                                                \
+        __attribute__((vector_size(4 * (lanes)), aligned(4)));                 \
+                                                                               \
+    void name(uint32_t state[GIMLI_WORDS * (lanes)])                           \
+    {                                                                          \
+        name##_vec *const p = (name##_vec *)state;                             \
+        name##_vec s[GIMLI_WORDS];                                             \
+        unsigned i;                                                            \
+        int round;                                                             \
+        for (i = 0; i < GIMLI_WORDS; ++i)                                      \
+        {                                                                      \
+            s[i] = p[i];                                                       \
+        }                                                                      \
+        for (round = 24; round > 0; round -= 4)                                \
+        {                                                                      \
+            LANES_SP_BOXES(s);                                                 \
+            /* small swap: pattern s...s...s... etc. */                        \
+            SWAP(s[0], s[1]);                                                  \
+            SWAP(s[2], s[3]);                                                  \
+            /* add constant: pattern c...c...c... etc. */                      \
+            s[0] ^= lanes_coeff(round);                                        \
+            LANES_SP_BOXES(s);                                                 \
+            LANES_SP_BOXES(s);                                                 \
+            /* big swap: pattern ..S...S...S. etc. */                          \
+            SWAP(s[0], s[2]);                                                  \
+            SWAP(s[1], s[3]);                                                  \
+            LANES_SP_BOXES(s);                                                 \
+        }                                                                      \
+        for (i = 0; i < GIMLI_WORDS; ++i)                                      \
+        {                                                                      \
+            p[i] = s[i];                                                       \
+        }                                                                      \
+    }
+
+GIMLI_LANES(gimli_x2, 2)
+GIMLI_LANES(gimli_x4, 4)
+GIMLI_LANES(gimli_x8, 8)
+GIMLI_LANES(gimli_x16, 16)
+
+#else /* !LITH_VECTORIZE */
+
+/*
+ * Without vector extensions, permute each state in turn with the scalar
+ * implementation.
+ */
+static void gimli_lanes(uint32_t *state, unsigned lanes)
+{
+    uint32_t s[GIMLI_WORDS];
+    unsigned lane, i;
+    for (lane = 0; lane < lanes; ++lane)
+    {
+        for (i = 0; i < GIMLI_WORDS; ++i)
+        {
+            s[i] = state[i * lanes + lane];
+        }
+        gimli(s);
+        for (i = 0; i < GIMLI_WORDS; ++i)
+        {
+            state[i * lanes + lane] = s[i];
+        }
+    }
+}
+
+void gimli_x2(uint32_t state[GIMLI_WORDS * 2])
+{
+    gimli_lanes(state, 2);
+}
+
+void gimli_x4(uint32_t state[GIMLI_WORDS * 4])
+{
+    gimli_lanes(state, 4);
+}
+
+void gimli_x8(uint32_t state[GIMLI_WORDS * 8])
+{
+    gimli_lanes(state, 8);
+}
+
+void gimli_x16(uint32_t state[GIMLI_WORDS * 16])
+{
+    gimli_lanes(state, 16);
+}
+
+#endif /* LITH_VECTORIZE */
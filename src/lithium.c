@@ -0,0 +1,40 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Single-file build of liblithium. Compiling only this file is equivalent to
+ * compiling each of the library sources in src/SConscript, but the compiler
+ * sees the whole library at once, so the sponge and hash functions can be
+ * inlined into each other without link-time optimization.
+ *
+ * random.c is not included, as the random source is a separate library.
+ */
+
+#include "opt.h"
+
+#if (LITH_DISPATCH)
+#error "the amalgamation does not support LITH_DISPATCH"
+#endif
+
+#include "backend.c"
+#include "fe.c"
+#include "gimli_checkpoint.c"
+#include "gimli_chunker.c"
+#include "gimli_ctr.c"
+#include "gimli.c"
+#include "gimli_x.c"
+#include "gimli_common.c"
+#include "gimli_aead.c"
+#include "gimli_aead_many.c"
+#include "gimli_hash.c"
+#include "gimli_hash_many.c"
+#include "gimli_short_hash.c"
+#include "gimli_stream.c"
+#include "gimli_strobe.c"
+#include "gimli_tree.c"
+#include "gimli_verity.c"
+#include "memzero.c"
+#include "sign.c"
+#include "x25519.c"
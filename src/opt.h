@@ -80,7 +80,10 @@
 /*
  * If vector loads from unaligned addresses are supported, sponge operations can
  * be vectorized. This requires SSE2 on x86 and unaligned accesses on ARM.
- * Vectorized sponge operations also assume little-endian order.
+ * Big-endian targets with VSX, such as POWER9, can define LITH_SPONGE_VECTORS
+ * to 1, and the sponge then byte-swaps each word of a block with a vector
+ * shuffle. That path has not been run against the KATs yet, so it is not
+ * enabled by default.
  */
 #if !defined(LITH_SPONGE_VECTORS) && (LITH_LITTLE_ENDIAN) &&                   \
     (defined(__SSE2__) || defined(__ARM_FEATURE_UNALIGNED))
@@ -115,6 +118,31 @@
 #define LITH_SHUFFLE_ROL24 0
 #endif
 
+/*
+ * The sponge primitives in gimli_common.h are defined in the header so that
+ * they are inlined without link-time optimization. -ansi has no inline
+ * keyword, so use the compiler's spelling of it where there is one.
+ */
+#ifndef LITH_INLINE
+#if defined(__GNUC__) || defined(__clang__)
+#define LITH_INLINE static __inline__
+#elif defined(_MSC_VER)
+#define LITH_INLINE static __inline
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+#define LITH_INLINE static inline
+#else
+#define LITH_INLINE static
+#endif
+#endif
+
+/*
+ * Build every x86 variant of the permutation into the library and select one
+ * at startup based on the CPU. See dispatch.h and backend.c.
+ */
+#ifndef LITH_DISPATCH
+#define LITH_DISPATCH 0
+#endif
+
 #if (LITH_SPONGE_VECTORS)
 typedef uint32_t block __attribute__((vector_size(16), aligned(1)));
 #endif
@@ -5,9 +5,11 @@
 
 #include <lithium/sign.h>
 
+#include <lithium/gimli_aead.h>
 #include <lithium/random.h>
 #include <lithium/x25519.h>
 
+#include "gimli_common.h"
 #include "memzero.h"
 
 #include <string.h>
@@ -34,6 +36,37 @@ void lith_sign_update(lith_sign_state *state, const unsigned char *msg,
     gimli_hash_update(state, msg, len);
 }
 
+void lith_sign_update_words(lith_sign_state *state, const uint32_t *msg,
+                            size_t nwords)
+{
+    gimli_hash_update_words(state, msg, nwords);
+}
+
+void lith_sign_update_iov(lith_sign_state *state, const lith_iovec *iov,
+                          size_t n)
+{
+    gimli_hash_update_iov(state, iov, n);
+}
+
+void lith_sign_decrypt_update(lith_sign_state *state, gimli_state *aead,
+                              unsigned char *msg, const unsigned char *c,
+                              size_t len)
+{
+    gimli_aead_decrypt_update_hash(aead, state, msg, c, len);
+}
+
+void lith_sign_export(const lith_sign_state *state,
+                      unsigned char out[LITH_SIGN_EXPORT_LEN])
+{
+    gimli_export(state, out, GIMLI_EXPORT_KIND_SIGN, NULL, 0);
+}
+
+bool lith_sign_import(lith_sign_state *state,
+                      const unsigned char in[LITH_SIGN_EXPORT_LEN])
+{
+    return gimli_import(state, in, GIMLI_EXPORT_KIND_SIGN, NULL, 0);
+}
+
 static void
 gen_challenge(gimli_hash_state *state, unsigned char challenge[X25519_LEN],
               const unsigned char public_nonce[X25519_LEN],
@@ -167,3 +200,32 @@ bool lith_sign_verify(const unsigned char sig[LITH_SIGN_LEN],
     lith_sign_update(&state, msg, len);
     return lith_sign_final_verify(&state, sig, public_key);
 }
+
+static void tree_prehash(unsigned char prehash[LITH_SIGN_PREHASH_LEN],
+                         const unsigned char root[GIMLI_TREE_HASH_LEN])
+{
+    gimli_hash_state state;
+    gimli_init_tagged(&state, GIMLI_TAG_TREE_SIGN);
+    gimli_hash_update(&state, root, GIMLI_TREE_HASH_LEN);
+    gimli_hash_final(&state, prehash, LITH_SIGN_PREHASH_LEN);
+}
+
+void lith_sign_create_tree_root(unsigned char sig[LITH_SIGN_LEN],
+                                const unsigned char root[GIMLI_TREE_HASH_LEN],
+                                const unsigned char
+                                    secret_key[LITH_SIGN_SECRET_KEY_LEN])
+{
+    unsigned char prehash[LITH_SIGN_PREHASH_LEN];
+    tree_prehash(prehash, root);
+    lith_sign_create_from_prehash(sig, prehash, secret_key);
+}
+
+bool lith_sign_verify_tree_root(const unsigned char sig[LITH_SIGN_LEN],
+                                const unsigned char root[GIMLI_TREE_HASH_LEN],
+                                const unsigned char
+                                    public_key[LITH_SIGN_PUBLIC_KEY_LEN])
+{
+    unsigned char prehash[LITH_SIGN_PREHASH_LEN];
+    tree_prehash(prehash, root);
+    return lith_sign_verify_prehash(sig, prehash, public_key);
+}
@@ -0,0 +1,100 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define N 40
+#define MAX_LEN 80
+#define MAX_TAG_LEN 40
+
+static unsigned char keys[N][GIMLI_AEAD_KEY_LEN];
+static unsigned char nonces[N][GIMLI_AEAD_NONCE_LEN];
+static unsigned char ad[MAX_LEN], msg[MAX_LEN];
+static unsigned char c[N][MAX_LEN], m[N][MAX_LEN], ref[N][MAX_LEN];
+static unsigned char t[N][MAX_TAG_LEN], ref_t[N][MAX_TAG_LEN];
+static gimli_aead_item items[N];
+
+/* Uneven lengths, so that the lanes finish at different times. */
+static void setup(size_t i)
+{
+    items[i].n = nonces[i];
+    items[i].k = keys[i];
+    items[i].ad = ad;
+    items[i].adlen = (i * 7) % 35;
+    items[i].in = msg;
+    items[i].out = c[i];
+    items[i].len = (i * 13) % MAX_LEN;
+    items[i].t = t[i];
+}
+
+static void check(size_t tlen)
+{
+    bool ok[N];
+    size_t i;
+
+    for (i = 0; i < N; ++i)
+    {
+        setup(i);
+        gimli_aead_encrypt(ref[i], ref_t[i], tlen, msg, items[i].len, ad,
+                           items[i].adlen, nonces[i], keys[i]);
+    }
+    gimli_aead_encrypt_many(items, N, tlen);
+    for (i = 0; i < N; ++i)
+    {
+        assert(memcmp(c[i], ref[i], items[i].len) == 0);
+        assert(memcmp(t[i], ref_t[i], tlen) == 0);
+    }
+
+    /* Decrypt in place, with one corrupted tag. */
+    for (i = 0; i < N; ++i)
+    {
+        (void)memcpy(m[i], c[i], items[i].len);
+        items[i].in = m[i];
+        items[i].out = m[i];
+    }
+    assert(gimli_aead_decrypt_many(ok, items, N, tlen));
+    for (i = 0; i < N; ++i)
+    {
+        assert(ok[i]);
+        assert(memcmp(m[i], msg, items[i].len) == 0);
+        (void)memcpy(m[i], c[i], items[i].len);
+    }
+    t[5][tlen - 1] ^= 1;
+    assert(!gimli_aead_decrypt_many(ok, items, N, tlen));
+    for (i = 0; i < N; ++i)
+    {
+        static const unsigned char zero[MAX_LEN] = {0};
+        assert(ok[i] == (i != 5));
+        assert(memcmp(m[i], (i == 5) ? zero : msg, items[i].len) == 0);
+    }
+}
+
+int main(void)
+{
+    size_t i, j;
+    for (i = 0; i < N; ++i)
+    {
+        for (j = 0; j < GIMLI_AEAD_KEY_LEN; ++j)
+        {
+            keys[i][j] = (unsigned char)(i * 3 + j);
+        }
+        for (j = 0; j < GIMLI_AEAD_NONCE_LEN; ++j)
+        {
+            nonces[i][j] = (unsigned char)(i * 5 + j * 7);
+        }
+    }
+    for (i = 0; i < MAX_LEN; ++i)
+    {
+        ad[i] = (unsigned char)(i + 100);
+        msg[i] = (unsigned char)(i * 9);
+    }
+    check(GIMLI_AEAD_TAG_DEFAULT_LEN);
+    check(8);
+    check(MAX_TAG_LEN);
+    return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/backend.h>
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+int main(void)
+{
+    static const char *const names[] = {
+        "scalar", "sse2", "ssse3", "avx2", "avx512", "neon", "altivec",
+    };
+    const char *const name = lith_backend();
+    size_t i;
+    for (i = 0; i < sizeof names / sizeof names[0]; ++i)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            printf("backend: %s\n", name);
+            return 0;
+        }
+    }
+    assert(0 && "unknown backend");
+    return 1;
+}
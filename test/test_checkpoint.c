@@ -0,0 +1,82 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_checkpoint.h>
+
+#include "gimli_common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define LEN 1000
+#define INTERVAL 64
+#define MAX_ENTRIES (LEN / INTERVAL)
+
+struct index
+{
+    unsigned char entries[MAX_ENTRIES][GIMLI_CHECKPOINT_LEN];
+    unsigned n;
+};
+
+static void save(void *ctx, const unsigned char entry[GIMLI_CHECKPOINT_LEN])
+{
+    struct index *index = ctx;
+    assert(index->n < MAX_ENTRIES);
+    (void)memcpy(index->entries[index->n++], entry, GIMLI_CHECKPOINT_LEN);
+}
+
+int main(void)
+{
+    static struct index index;
+    unsigned char msg[LEN], bad[GIMLI_CHECKPOINT_LEN];
+    unsigned char h1[GIMLI_HASH_DEFAULT_LEN], h2[GIMLI_HASH_DEFAULT_LEN];
+    gimli_checkpoint_state c;
+    size_t i;
+
+    for (i = 0; i < LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 3);
+    }
+
+    /* Updates that cross checkpoints still give the plain hash. */
+    gimli_checkpoint_init(&c, INTERVAL);
+    for (i = 0; i < LEN; i += 100)
+    {
+        gimli_checkpoint_update(&c, &msg[i], 100, save, &index);
+    }
+    gimli_hash_final(&c.hash, h1, sizeof h1);
+    gimli_hash(h2, sizeof h2, msg, LEN);
+    assert(memcmp(h1, h2, sizeof h1) == 0);
+    assert(index.n == MAX_ENTRIES);
+
+    /* Change a byte and resume from the last checkpoint before it. */
+    msg[700] ^= 1;
+    gimli_hash(h1, sizeof h1, msg, LEN);
+    assert(gimli_checkpoint_resume(&c, index.entries[700 / INTERVAL - 1],
+                                   INTERVAL));
+    assert(c.pos == (700 / INTERVAL) * INTERVAL);
+    /* The later entries are replaced. */
+    index.n = 700 / INTERVAL;
+    gimli_checkpoint_update(&c, &msg[c.pos], LEN - (size_t)c.pos, save,
+                            &index);
+    gimli_hash_final(&c.hash, h2, sizeof h2);
+    assert(memcmp(h1, h2, sizeof h1) == 0);
+    assert(index.n == MAX_ENTRIES);
+
+    /* The position is covered by the check value. */
+    (void)memcpy(bad, index.entries[0], sizeof bad);
+    bad[0] ^= INTERVAL;
+    assert(!gimli_checkpoint_resume(&c, bad, INTERVAL));
+    assert(!gimli_checkpoint_resume(&c, index.entries[0], INTERVAL * 3));
+
+    /*
+     * Entries are read back from storage, and anyone can compute the check
+     * value, so an entry with a full rate must be refused.
+     */
+    (void)memcpy(bad, index.entries[0], sizeof bad);
+    c.hash.offset = GIMLI_RATE;
+    gimli_export(&c.hash, &bad[8], GIMLI_EXPORT_KIND_CHECKPOINT, bad, 8);
+    assert(!gimli_checkpoint_resume(&c, bad, INTERVAL));
+}
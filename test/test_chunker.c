@@ -0,0 +1,131 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_chunker.h>
+#include <lithium/gimli_hash.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define LEN (400U * 1024U)
+#define MAX_CHUNKS (LEN / GIMLI_CHUNK_MIN_LEN + 2)
+#define INSERT 100U
+
+static unsigned char data[LEN + INSERT];
+
+struct list
+{
+    gimli_chunk chunks[MAX_CHUNKS];
+    size_t n;
+};
+
+static struct list whole, pieces, edited;
+
+static void add_chunk(void *ctx, const gimli_chunk *chunk)
+{
+    struct list *const l = ctx;
+    assert(l->n < MAX_CHUNKS);
+    l->chunks[l->n++] = *chunk;
+}
+
+static void chunk(struct list *l, const unsigned char *m, size_t len,
+                  size_t piece)
+{
+    static const unsigned char key[GIMLI_CHUNK_KEY_LEN] = {1, 2, 3};
+    static gimli_chunker_state c;
+    size_t i;
+    l->n = 0;
+    gimli_chunker_init(&c, key);
+    for (i = 0; i < len; i += piece)
+    {
+        gimli_chunker_update(&c, &m[i], (len - i < piece) ? len - i : piece,
+                             add_chunk, l);
+    }
+    gimli_chunker_final(&c, add_chunk, l);
+}
+
+/* The chunks cover the input in order, and each digest is its gimli_hash. */
+static void check_list(const struct list *l, const unsigned char *m,
+                       size_t len)
+{
+    unsigned char h[GIMLI_CHUNK_DIGEST_LEN];
+    uint64_t offset = 0;
+    size_t i;
+    for (i = 0; i < l->n; ++i)
+    {
+        const gimli_chunk *const c = &l->chunks[i];
+        assert(c->offset == offset);
+        assert(c->len <= GIMLI_CHUNK_MAX_LEN);
+        assert((c->len >= GIMLI_CHUNK_MIN_LEN) || (i == l->n - 1));
+        gimli_hash(h, sizeof h, &m[offset], (size_t)c->len);
+        assert(memcmp(h, c->digest, sizeof h) == 0);
+        offset += c->len;
+    }
+    assert(offset == len);
+}
+
+static bool has_digest(const struct list *l, const unsigned char *digest)
+{
+    size_t i;
+    for (i = 0; i < l->n; ++i)
+    {
+        if (memcmp(l->chunks[i].digest, digest, GIMLI_CHUNK_DIGEST_LEN) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(void)
+{
+    static const size_t piece_lens[] = {1, 1000, 4096, 100000};
+    uint32_t x = 1;
+    size_t i, p, same = 0;
+    unsigned char entry[GIMLI_CHUNK_ENTRY_LEN];
+
+    /* Pseudorandom data, with a run of zeros to reach the maximum length. */
+    for (i = 0; i < LEN; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = (unsigned char)x;
+    }
+    (void)memset(&data[200000], 0, 150000);
+
+    chunk(&whole, data, LEN, LEN);
+    check_list(&whole, data, LEN);
+    assert(whole.n > 10);
+    for (p = 0; p < sizeof piece_lens / sizeof piece_lens[0]; ++p)
+    {
+        chunk(&pieces, data, LEN, piece_lens[p]);
+        assert(pieces.n == whole.n);
+        for (i = 0; i < whole.n; ++i)
+        {
+            assert(pieces.chunks[i].len == whole.chunks[i].len);
+            assert(memcmp(pieces.chunks[i].digest, whole.chunks[i].digest,
+                          GIMLI_CHUNK_DIGEST_LEN) == 0);
+        }
+    }
+
+    /* Inserting bytes near the start only changes the chunks around them. */
+    (void)memmove(&data[5000 + INSERT], &data[5000], LEN - 5000);
+    (void)memset(&data[5000], 0xA5, INSERT);
+    chunk(&edited, data, LEN + INSERT, LEN);
+    check_list(&edited, data, LEN + INSERT);
+    for (i = 0; i < edited.n; ++i)
+    {
+        same += has_digest(&whole, edited.chunks[i].digest);
+    }
+    assert(same + 3 >= edited.n);
+
+    gimli_chunk_encode(entry, &whole.chunks[1]);
+    assert(entry[0] == (whole.chunks[1].offset & 0xFFU));
+    assert(entry[8] == (whole.chunks[1].len & 0xFFU));
+    assert(memcmp(&entry[16], whole.chunks[1].digest,
+                  GIMLI_CHUNK_DIGEST_LEN) == 0);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_ctr.h>
+
+#include "gimli_common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define LEN 5000U
+#define SPLIT 1024U
+
+static const unsigned char key[GIMLI_CTR_KEY_LEN] = {1, 2, 3};
+static const unsigned char nonce[GIMLI_CTR_NONCE_LEN] = {4, 5, 6};
+static const unsigned char ad[] = "associated data";
+
+static unsigned char msg[LEN], c[LEN], m[LEN];
+
+/* Each block of keystream is computed on its own with the permutation. */
+static void check_keystream(void)
+{
+    gimli_ctr_state s;
+    unsigned char zeros[100], ks[100];
+    size_t block, i;
+    gimli_ctr_init(&s, nonce, key);
+    (void)memset(zeros, 0, sizeof zeros);
+    gimli_ctr_xor(&s, ks, zeros, sizeof ks, 3);
+    for (block = 0; block * GIMLI_RATE < sizeof ks; ++block)
+    {
+        uint32_t x[GIMLI_WORDS];
+        unsigned char expected[GIMLI_RATE];
+        (void)memcpy(x, s.base, sizeof x);
+        x[GIMLI_RATE / 4] ^= GIMLI_TAG_CTR_STREAM;
+        x[GIMLI_RATE / 4 + 4] ^= (uint32_t)(3 + block);
+        gimli(x);
+        for (i = 0; i < GIMLI_RATE / 4; ++i)
+        {
+            gimli_store(&expected[i * 4], x[i]);
+        }
+        for (i = 0; (i < GIMLI_RATE) && (block * GIMLI_RATE + i < sizeof ks);
+             ++i)
+        {
+            assert(ks[block * GIMLI_RATE + i] == expected[i]);
+        }
+    }
+}
+
+static void check_len(size_t len)
+{
+    unsigned char t[GIMLI_CTR_TAG_LEN];
+    size_t i;
+
+    gimli_ctr_encrypt(c, t, msg, len, ad, sizeof ad, nonce, key);
+    assert(gimli_ctr_decrypt(m, c, len, t, ad, sizeof ad, nonce, key));
+    assert(memcmp(m, msg, len) == 0);
+
+    /* In place. */
+    (void)memcpy(m, msg, len);
+    gimli_ctr_encrypt(m, t, m, len, ad, sizeof ad, nonce, key);
+    assert(memcmp(m, c, len) == 0);
+    assert(gimli_ctr_decrypt(m, m, len, t, ad, sizeof ad, nonce, key));
+    assert(memcmp(m, msg, len) == 0);
+
+    /* A changed tag, ciphertext, or associated data is rejected. */
+    t[0] ^= 1;
+    assert(!gimli_ctr_decrypt(m, c, len, t, ad, sizeof ad, nonce, key));
+    for (i = 0; i < len; ++i)
+    {
+        assert(m[i] == 0);
+    }
+    t[0] ^= 1;
+    assert(!gimli_ctr_decrypt(m, c, len, t, ad, sizeof ad - 1, nonce, key));
+    if (len > 0)
+    {
+        c[len - 1] ^= 0x80;
+        assert(!gimli_ctr_decrypt(m, c, len, t, ad, sizeof ad, nonce, key));
+    }
+}
+
+/* Ranges of blocks encrypted separately, as on separate threads. */
+static void check_split(void)
+{
+    gimli_ctr_state s;
+    unsigned char t[GIMLI_CTR_TAG_LEN], split_t[GIMLI_CTR_TAG_LEN];
+    unsigned char sum[GIMLI_CTR_TAG_LEN], sum2[GIMLI_CTR_TAG_LEN];
+    size_t i;
+
+    gimli_ctr_encrypt(c, t, msg, LEN, ad, sizeof ad, nonce, key);
+
+    gimli_ctr_init(&s, nonce, key);
+    (void)memset(sum, 0, sizeof sum);
+    (void)memset(sum2, 0, sizeof sum2);
+    gimli_ctr_xor(&s, &m[SPLIT], &msg[SPLIT], LEN - SPLIT,
+                  SPLIT / GIMLI_CTR_BLOCK_LEN);
+    gimli_ctr_mac_update(&s, sum2, &m[SPLIT], LEN - SPLIT,
+                         SPLIT / GIMLI_CTR_BLOCK_LEN);
+    gimli_ctr_xor(&s, m, msg, SPLIT, 0);
+    gimli_ctr_mac_update(&s, sum, m, SPLIT, 0);
+    for (i = 0; i < sizeof sum; ++i)
+    {
+        sum[i] ^= sum2[i];
+    }
+    gimli_ctr_mac_final(&s, split_t, sum, ad, sizeof ad, LEN);
+
+    assert(memcmp(m, c, LEN) == 0);
+    assert(memcmp(split_t, t, sizeof t) == 0);
+}
+
+int main(void)
+{
+    static const size_t lens[] = {0, 1, 15, 16, 17, 100, 4096, 4097, LEN};
+    size_t i;
+
+    for (i = 0; i < LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 7);
+    }
+
+    check_keystream();
+    for (i = 0; i < sizeof lens / sizeof lens[0]; ++i)
+    {
+        check_len(lens[i]);
+    }
+    check_split();
+    return 0;
+}
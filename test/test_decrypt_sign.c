@@ -0,0 +1,81 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+#include <lithium/sign.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define LEN 3000U
+
+static const unsigned char nonce[GIMLI_AEAD_NONCE_LEN] = {1, 2, 3};
+static const unsigned char key[GIMLI_AEAD_KEY_LEN] = {4, 5, 6};
+
+static unsigned char msg[LEN], c[LEN], m[LEN];
+
+/*
+ * Decrypt and sign in pieces of piece bytes, after the signature state has
+ * absorbed skew bytes of a header, so that the two states are not always at
+ * the same offset within a block.
+ */
+static void check(const unsigned char t[GIMLI_AEAD_TAG_DEFAULT_LEN],
+                  size_t piece, size_t skew)
+{
+    gimli_state aead, sign, expected;
+    size_t pos;
+
+    gimli_aead_init(&aead, nonce, key);
+    gimli_aead_final_ad(&aead);
+    lith_sign_init(&sign);
+    lith_sign_update(&sign, msg, skew);
+    expected = sign;
+    lith_sign_update(&expected, msg, LEN);
+
+    (void)memset(m, 0, sizeof m);
+    for (pos = 0; pos < LEN; pos += piece)
+    {
+        const size_t len = (LEN - pos < piece) ? LEN - pos : piece;
+        lith_sign_decrypt_update(&sign, &aead, &m[pos], &c[pos], len);
+    }
+    assert(memcmp(m, msg, LEN) == 0);
+    assert(gimli_aead_decrypt_final(&aead, t, GIMLI_AEAD_TAG_DEFAULT_LEN));
+    assert(sign.offset == expected.offset);
+    assert(memcmp(sign.state, expected.state, sizeof sign.state) == 0);
+}
+
+int main(void)
+{
+    static const size_t pieces[] = {1, 7, 16, 33, 1024, LEN};
+    unsigned char t[GIMLI_AEAD_TAG_DEFAULT_LEN];
+    unsigned char pk[LITH_SIGN_PUBLIC_KEY_LEN], sk[LITH_SIGN_SECRET_KEY_LEN];
+    unsigned char sig[LITH_SIGN_LEN];
+    lith_sign_state sign;
+    gimli_state aead;
+    size_t i;
+
+    for (i = 0; i < LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 13);
+    }
+    gimli_aead_encrypt(c, t, sizeof t, msg, LEN, NULL, 0, nonce, key);
+
+    for (i = 0; i < sizeof pieces / sizeof pieces[0]; ++i)
+    {
+        check(t, pieces[i], 0);
+        check(t, pieces[i], 5);
+    }
+
+    /* Verify an encrypted, signed image in one pass. */
+    lith_sign_keygen(pk, sk);
+    lith_sign_create(sig, msg, LEN, sk);
+    gimli_aead_init(&aead, nonce, key);
+    gimli_aead_final_ad(&aead);
+    lith_sign_init(&sign);
+    lith_sign_decrypt_update(&sign, &aead, m, c, LEN);
+    assert(gimli_aead_decrypt_final(&aead, t, sizeof t));
+    assert(lith_sign_final_verify(&sign, sig, pk));
+    return 0;
+}
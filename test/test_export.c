@@ -0,0 +1,77 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+#include <lithium/sign.h>
+
+#include "gimli_common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define LEN 100
+
+int main(void)
+{
+    unsigned char msg[LEN], ex[GIMLI_HASH_EXPORT_LEN], bad[sizeof ex];
+    unsigned char h1[GIMLI_HASH_DEFAULT_LEN], h2[GIMLI_HASH_DEFAULT_LEN];
+    gimli_hash_state g, r;
+    size_t split, i;
+
+    assert(GIMLI_EXPORT_LEN == GIMLI_HASH_EXPORT_LEN);
+    assert(GIMLI_EXPORT_LEN == LITH_SIGN_EXPORT_LEN);
+
+    for (i = 0; i < LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 5 + 1);
+    }
+    gimli_hash(h1, sizeof h1, msg, LEN);
+
+    /* Resume from an export at every offset. */
+    for (split = 0; split <= LEN; ++split)
+    {
+        gimli_hash_init(&g);
+        gimli_hash_update(&g, msg, split);
+        gimli_hash_export(&g, ex);
+        (void)memset(&r, 0xAA, sizeof r);
+        assert(gimli_hash_import(&r, ex));
+        gimli_hash_update(&r, &msg[split], LEN - split);
+        gimli_hash_final(&r, h2, sizeof h2);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+    }
+
+    /* The layout is little-endian on every platform. */
+    assert(ex[4] == (g.state[0] & 0xFFU));
+    assert(ex[7] == (g.state[0] >> 24));
+
+    /* Any single changed byte is rejected, and g is left unchanged. */
+    r = g;
+    for (i = 0; i < sizeof ex; ++i)
+    {
+        (void)memcpy(bad, ex, sizeof ex);
+        bad[i] ^= 0x10;
+        assert(!gimli_hash_import(&r, bad));
+        assert(memcmp(&r, &g, sizeof r) == 0);
+    }
+
+    /* Exports can't be imported as the other kind of state. */
+    assert(!lith_sign_import(&r, ex));
+    lith_sign_export(&g, ex);
+    assert(lith_sign_import(&r, ex));
+    assert(!gimli_hash_import(&r, ex));
+
+    /*
+     * The check value is public, so an export with a full rate and a valid
+     * check value can be forged. It must be rejected, because the next update
+     * would write past the state.
+     */
+    gimli_hash_init(&g);
+    gimli_hash_update(&g, msg, LEN);
+    g.offset = GIMLI_RATE;
+    gimli_hash_export(&g, ex);
+    assert(!gimli_hash_import(&r, ex));
+    lith_sign_export(&g, ex);
+    assert(!lith_sign_import(&r, ex));
+}
@@ -0,0 +1,51 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define N 37
+#define MAX_LEN 200
+#define MAX_OUT 50
+
+int main(void)
+{
+    static unsigned char buf[N][MAX_LEN];
+    static const size_t out_lens[] = {
+        GIMLI_HASH_DEFAULT_LEN, 0, 1, 16, MAX_OUT,
+    };
+    static unsigned char out[N][MAX_OUT];
+    unsigned char *outs[N];
+    const unsigned char *msgs[N];
+    size_t lens[N];
+    size_t i, j, k;
+
+    for (i = 0; i < N; ++i)
+    {
+        for (j = 0; j < MAX_LEN; ++j)
+        {
+            buf[i][j] = (unsigned char)(i * 31 + j);
+        }
+        outs[i] = out[i];
+        msgs[i] = buf[i];
+        /* Mix equal, short, block-aligned, and uneven lengths. */
+        lens[i] = (i < 8) ? 64 : (i * 53) % (MAX_LEN + 1);
+    }
+
+    /* Outputs longer than a block take more than one squeeze step. */
+    for (k = 0; k < sizeof out_lens / sizeof out_lens[0]; ++k)
+    {
+        const size_t out_len = out_lens[k];
+        gimli_hash_many(outs, out_len, msgs, lens, N);
+        for (i = 0; i < N; ++i)
+        {
+            unsigned char h[MAX_OUT];
+            gimli_hash(h, out_len, msgs[i], lens[i]);
+            assert(memcmp(h, out[i], out_len) == 0);
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define MAX_LANES 16
+
+static void check_lanes(void (*gimli_xn)(uint32_t *), unsigned lanes)
+{
+    uint32_t s[MAX_LANES][GIMLI_WORDS];
+    uint32_t x[GIMLI_WORDS * MAX_LANES];
+    unsigned lane, i;
+
+    for (lane = 0; lane < lanes; ++lane)
+    {
+        for (i = 0; i < GIMLI_WORDS; ++i)
+        {
+            s[lane][i] = i * i * i + i * 0x9E3779B9 + lane * 0x7F4A7C15;
+            x[i * lanes + lane] = s[lane][i];
+        }
+        gimli(s[lane]);
+    }
+
+    gimli_xn(x);
+
+    for (lane = 0; lane < lanes; ++lane)
+    {
+        for (i = 0; i < GIMLI_WORDS; ++i)
+        {
+            assert(x[i * lanes + lane] == s[lane][i]);
+        }
+    }
+}
+
+int main(void)
+{
+    check_lanes(gimli_x2, 2);
+    check_lanes(gimli_x4, 4);
+    check_lanes(gimli_x8, 8);
+    check_lanes(gimli_x16, 16);
+}
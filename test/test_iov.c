@@ -0,0 +1,121 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+#include <lithium/gimli_hash.h>
+#include <lithium/sign.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define MAX_LEN 400
+#define MAX_FRAGMENTS MAX_LEN
+
+static unsigned char msg[MAX_LEN];
+
+/*
+ * Split buf into fragments whose lengths cycle through lens, which include
+ * empty fragments and lengths that are not multiples of the block size.
+ */
+static size_t split(lith_iovec iov[MAX_FRAGMENTS], unsigned char *buf,
+                    size_t len, const size_t *lens, size_t nlens)
+{
+    size_t n = 0, pos = 0;
+    while (pos < len)
+    {
+        size_t l = lens[n % nlens];
+        if (l > len - pos)
+        {
+            l = len - pos;
+        }
+        iov[n].base = &buf[pos];
+        iov[n].len = l;
+        pos += l;
+        ++n;
+    }
+    return n;
+}
+
+static void check(const size_t *lens, size_t nlens)
+{
+    static const unsigned char nonce[GIMLI_AEAD_NONCE_LEN] = {7};
+    static const unsigned char key[GIMLI_AEAD_KEY_LEN] = {8};
+    unsigned char c1[MAX_LEN], c2[MAX_LEN], buf[MAX_LEN];
+    unsigned char h1[GIMLI_HASH_DEFAULT_LEN], h2[GIMLI_HASH_DEFAULT_LEN];
+    unsigned char t1[GIMLI_AEAD_TAG_DEFAULT_LEN];
+    unsigned char t2[GIMLI_AEAD_TAG_DEFAULT_LEN];
+    lith_iovec m_iov[MAX_FRAGMENTS], c_iov[MAX_FRAGMENTS];
+    lith_iovec b_iov[MAX_FRAGMENTS];
+    gimli_hash_state hs;
+    lith_sign_state ss;
+    gimli_state as;
+    size_t n;
+
+    gimli_hash(h1, sizeof h1, msg, sizeof msg);
+    n = split(m_iov, msg, sizeof msg, lens, nlens);
+    gimli_hash_init(&hs);
+    gimli_hash_update_iov(&hs, m_iov, n);
+    gimli_hash_final(&hs, h2, sizeof h2);
+    assert(memcmp(h1, h2, sizeof h1) == 0);
+
+    /* Start in the middle of a block. */
+    gimli_hash_init(&hs);
+    gimli_hash_update(&hs, msg, 5);
+    gimli_hash_update_iov(&hs, m_iov, n);
+    lith_sign_init(&ss);
+    lith_sign_update(&ss, msg, 5);
+    lith_sign_update_iov(&ss, m_iov, n);
+    assert(memcmp(&hs, &ss, sizeof hs) == 0);
+
+    gimli_aead_encrypt(c1, t1, sizeof t1, msg, sizeof msg, msg, 37, nonce,
+                       key);
+
+    /* Out of place, with the associated data in fragments too. */
+    (void)split(c_iov, c2, sizeof c2, lens, nlens);
+    gimli_aead_init(&as, nonce, key);
+    gimli_aead_update_ad_iov(&as, b_iov, split(b_iov, msg, 37, lens, nlens));
+    gimli_aead_final_ad(&as);
+    gimli_aead_encrypt_update_iov(&as, c_iov, m_iov, n);
+    gimli_aead_encrypt_final(&as, t2, sizeof t2);
+    assert(memcmp(c1, c2, sizeof c1) == 0);
+    assert(memcmp(t1, t2, sizeof t1) == 0);
+
+    /* In place. */
+    (void)memcpy(buf, msg, sizeof buf);
+    (void)split(b_iov, buf, sizeof buf, lens, nlens);
+    gimli_aead_init(&as, nonce, key);
+    gimli_aead_update_ad(&as, msg, 37);
+    gimli_aead_final_ad(&as);
+    gimli_aead_encrypt_update_iov(&as, b_iov, b_iov, n);
+    gimli_aead_encrypt_final(&as, t2, sizeof t2);
+    assert(memcmp(c1, buf, sizeof c1) == 0);
+    assert(memcmp(t1, t2, sizeof t1) == 0);
+
+    gimli_aead_init(&as, nonce, key);
+    gimli_aead_update_ad(&as, msg, 37);
+    gimli_aead_final_ad(&as);
+    gimli_aead_decrypt_update_iov(&as, b_iov, b_iov, n);
+    assert(gimli_aead_decrypt_final(&as, t1, sizeof t1));
+    assert(memcmp(msg, buf, sizeof msg) == 0);
+}
+
+int main(void)
+{
+    static const size_t all_one[] = {1};
+    static const size_t uneven[] = {5, 0, 17, 3, 64, 1, 0, 31};
+    static const size_t blocks[] = {16, 48, 32};
+    static const size_t large[] = {150, 7, 243};
+    size_t i;
+
+    for (i = 0; i < sizeof msg; ++i)
+    {
+        msg[i] = (unsigned char)(i * 11 + 5);
+    }
+    check(all_one, 1);
+    check(uneven, sizeof uneven / sizeof uneven[0]);
+    check(blocks, sizeof blocks / sizeof blocks[0]);
+    check(large, sizeof large / sizeof large[0]);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Generate the Gimli-Hash KAT file with the constexpr implementation in
+ * <lithium/gimli_hash.hpp>, in the same format as test_lwc_hash_kat.c, and
+ * check a few of the digests at compile time.
+ */
+
+#include <lithium/gimli_hash.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+namespace
+{
+
+constexpr std::size_t max_message_length = 1024;
+
+constexpr std::array<unsigned char, max_message_length> init_buffer()
+{
+    std::array<unsigned char, max_message_length> buffer{};
+    for (std::size_t i = 0; i < buffer.size(); ++i)
+    {
+        buffer[i] = static_cast<unsigned char>(i);
+    }
+    return buffer;
+}
+
+constexpr std::array<unsigned char, max_message_length> msg = init_buffer();
+
+template <std::size_t N>
+constexpr bool equal(const std::array<unsigned char, N> &a,
+                     const std::array<unsigned char, N> &b)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Count = 1 and Count = 3 from LWC_HASH_KAT_256.txt. */
+static_assert(equal(lith::gimli_hash(msg.data(), 0),
+                    std::array<unsigned char, 32>{
+                        0x27, 0xAE, 0x20, 0xE9, 0x5F, 0xBC, 0x2B, 0xF0,
+                        0x1E, 0x97, 0x2B, 0x00, 0x15, 0xEE, 0xA4, 0x31,
+                        0xC2, 0x0F, 0xC8, 0x81, 0x8F, 0x25, 0xBC, 0x6D,
+                        0xBE, 0x66, 0x23, 0x22, 0x30, 0xDB, 0x35, 0x2F}));
+static_assert(equal(lith::gimli_hash(msg.data(), 2),
+                    std::array<unsigned char, 32>{
+                        0x5F, 0xEA, 0xFD, 0x3C, 0x60, 0x3B, 0x3B, 0xD7,
+                        0xB3, 0x1E, 0xE0, 0x98, 0x2C, 0x53, 0x30, 0xE8,
+                        0x34, 0x8C, 0xB5, 0xB4, 0xCC, 0x9A, 0x10, 0xED,
+                        0xB8, 0x60, 0xE1, 0x22, 0x60, 0x63, 0xD0, 0x47}));
+static_assert(equal(lith::gimli_hash(std::string_view("\x00\x01", 2)),
+                    lith::gimli_hash(msg.data(), 2)));
+
+void print_bstr(const char *label, const unsigned char *data,
+                std::size_t length)
+{
+    std::printf("%s", label);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        std::printf("%02X", data[i]);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main()
+{
+    int count = 1;
+    for (std::size_t mlen = 0; mlen <= max_message_length; ++mlen)
+    {
+        const auto digest = lith::gimli_hash(msg.data(), mlen);
+        std::printf("Count = %d\n", count++);
+        print_bstr("Msg = ", msg.data(), mlen);
+        print_bstr("MD = ", digest.data(), digest.size());
+        std::printf("\n");
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_hash.h>
+#include <lithium/gimli_short_hash.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define MAX_LEN 100
+#define N (MAX_LEN + 1)
+
+static unsigned char msg[MAX_LEN];
+
+/*
+ * The short hashes are Gimli-Hash from an initial state with a domain tag, 5
+ * for 64-bit outputs and 6 for 128-bit outputs, in word 4 and the key in
+ * words 5 to 8.
+ */
+static void reference(unsigned char *h, size_t hlen, uint32_t tag,
+                      const unsigned char *m, size_t len,
+                      const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN])
+{
+    gimli_hash_state g;
+    unsigned i;
+    gimli_hash_init(&g);
+    g.state[4] = tag;
+    for (i = 0; i < 4; ++i)
+    {
+        g.state[5 + i] = (uint32_t)key[i * 4] |
+                         ((uint32_t)key[i * 4 + 1] << 8) |
+                         ((uint32_t)key[i * 4 + 2] << 16) |
+                         ((uint32_t)key[i * 4 + 3] << 24);
+    }
+    gimli_hash_update(&g, m, len);
+    gimli_hash_final(&g, h, hlen);
+}
+
+static uint64_t load64(const unsigned char b[8])
+{
+    uint64_t x = 0;
+    unsigned i;
+    for (i = 8; i > 0; --i)
+    {
+        x = (x << 8) | b[i - 1];
+    }
+    return x;
+}
+
+int main(void)
+{
+    static const unsigned char key[GIMLI_SHORT_HASH_KEY_LEN] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    };
+    static unsigned char out[N][GIMLI_SHORT_HASH_128_LEN];
+    unsigned char *outs[N];
+    const unsigned char *msgs[N];
+    size_t lens[N];
+    uint64_t h64[N];
+    unsigned char ref[GIMLI_SHORT_HASH_128_LEN], h[GIMLI_SHORT_HASH_128_LEN];
+    unsigned char other_key[GIMLI_SHORT_HASH_KEY_LEN];
+    size_t len;
+
+    for (len = 0; len < MAX_LEN; ++len)
+    {
+        msg[len] = (unsigned char)(len * 13 + 1);
+    }
+
+    /* Every length, in a scattered order so that the lanes are uneven. */
+    for (len = 0; len < N; ++len)
+    {
+        outs[len] = out[len];
+        msgs[len] = msg;
+        lens[len] = (len * 37) % N;
+    }
+    gimli_short_hash64_many(h64, msgs, lens, N, key);
+    gimli_short_hash128_many(outs, msgs, lens, N, key);
+
+    for (len = 0; len < N; ++len)
+    {
+        reference(ref, 8, 5, msg, lens[len], key);
+        assert(gimli_short_hash64(msg, lens[len], key) == load64(ref));
+        assert(h64[len] == load64(ref));
+
+        reference(ref, sizeof ref, 6, msg, lens[len], key);
+        gimli_short_hash128(h, msg, lens[len], key);
+        assert(memcmp(h, ref, sizeof h) == 0);
+        assert(memcmp(out[len], ref, sizeof ref) == 0);
+    }
+
+    /* The two output lengths and different keys are independent. */
+    gimli_short_hash128(h, msg, 24, key);
+    assert(gimli_short_hash64(msg, 24, key) != load64(h));
+    (void)memcpy(other_key, key, sizeof key);
+    other_key[15] ^= 1;
+    assert(gimli_short_hash64(msg, 24, key) !=
+           gimli_short_hash64(msg, 24, other_key));
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+#include <lithium/gimli_hash.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define MAX_LEN 300
+
+/*
+ * Feed the sponge in pieces of every length from 1 to 40 bytes, so that the
+ * byte, word, and block paths start at every offset, and check that the
+ * results match the one-shot functions. The XOF output is squeezed in pieces
+ * the same way, and each piece length is also used as a prefix for
+ * gimli_hash_from.
+ */
+int main(void)
+{
+    static const unsigned char n[GIMLI_AEAD_NONCE_LEN] = {1, 2, 3};
+    static const unsigned char k[GIMLI_AEAD_KEY_LEN] = {4, 5, 6};
+    unsigned char msg[MAX_LEN], c1[MAX_LEN], c2[MAX_LEN], m2[MAX_LEN];
+    unsigned char h1[GIMLI_HASH_DEFAULT_LEN], h2[GIMLI_HASH_DEFAULT_LEN];
+    unsigned char x1[MAX_LEN], x2[MAX_LEN];
+    unsigned char t1[GIMLI_AEAD_TAG_DEFAULT_LEN], t2[GIMLI_AEAD_TAG_DEFAULT_LEN];
+    size_t piece, i;
+
+    for (i = 0; i < MAX_LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 7 + 3);
+    }
+
+    gimli_hash(h1, sizeof h1, msg, sizeof msg);
+    gimli_hash(x1, sizeof x1, msg, 21);
+    gimli_aead_encrypt(c1, t1, sizeof t1, msg, sizeof msg, msg, 21, n, k);
+
+    for (piece = 1; piece <= 40; ++piece)
+    {
+        gimli_hash_state hs;
+        gimli_state as;
+
+        gimli_hash_init(&hs);
+        for (i = 0; i < sizeof msg; i += piece)
+        {
+            const size_t len = (sizeof msg - i < piece) ? sizeof msg - i : piece;
+            gimli_hash_update(&hs, &msg[i], len);
+        }
+        gimli_hash_final(&hs, h2, sizeof h2);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+
+        /* The prefix state is reused, so hash from it twice. */
+        gimli_hash_init(&hs);
+        gimli_hash_update(&hs, msg, piece);
+        for (i = 0; i < 2; ++i)
+        {
+            gimli_hash_from(h2, sizeof h2, &hs, &msg[piece],
+                            sizeof msg - piece);
+            assert(memcmp(h1, h2, sizeof h1) == 0);
+        }
+
+        gimli_hash_init(&hs);
+        gimli_hash_update(&hs, msg, 21);
+        gimli_xof_init(&hs);
+        for (i = 0; i < sizeof x2; i += piece)
+        {
+            const size_t len = (sizeof x2 - i < piece) ? sizeof x2 - i : piece;
+            gimli_xof_squeeze(&hs, &x2[i], len);
+        }
+        assert(memcmp(x1, x2, sizeof x1) == 0);
+
+        gimli_aead_init(&as, n, k);
+        gimli_aead_update_ad(&as, msg, 21);
+        gimli_aead_final_ad(&as);
+        for (i = 0; i < sizeof msg; i += piece)
+        {
+            const size_t len = (sizeof msg - i < piece) ? sizeof msg - i : piece;
+            gimli_aead_encrypt_update(&as, &c2[i], &msg[i], len);
+        }
+        gimli_aead_encrypt_final(&as, t2, sizeof t2);
+        assert(memcmp(c1, c2, sizeof c1) == 0);
+        assert(memcmp(t1, t2, sizeof t1) == 0);
+
+        gimli_aead_init(&as, n, k);
+        gimli_aead_update_ad(&as, msg, 21);
+        gimli_aead_final_ad(&as);
+        for (i = 0; i < sizeof msg; i += piece)
+        {
+            const size_t len = (sizeof msg - i < piece) ? sizeof msg - i : piece;
+            gimli_aead_decrypt_update(&as, &m2[i], &c1[i], len);
+        }
+        assert(gimli_aead_decrypt_final(&as, t1, sizeof t1));
+        assert(memcmp(msg, m2, sizeof msg) == 0);
+    }
+}
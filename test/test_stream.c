@@ -0,0 +1,93 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_stream.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define CHUNK 100U
+#define CHUNKS 5U
+#define LAST_LEN 37U
+#define LEN ((CHUNKS - 1) * CHUNK + LAST_LEN)
+#define STORED (CHUNKS * (CHUNK + GIMLI_STREAM_TAG_LEN))
+
+static const unsigned char prefix[GIMLI_STREAM_PREFIX_LEN] = {1, 2, 3};
+static const unsigned char key[GIMLI_STREAM_KEY_LEN] = {4, 5, 6};
+
+static unsigned char msg[LEN], stored[STORED], out[CHUNK];
+
+static size_t chunk_len(size_t i)
+{
+    return (i == CHUNKS - 1) ? LAST_LEN : CHUNK;
+}
+
+static unsigned char *chunk_at(size_t i)
+{
+    return &stored[i * (CHUNK + GIMLI_STREAM_TAG_LEN)];
+}
+
+static const unsigned char *tag_at(size_t i)
+{
+    return chunk_at(i) + chunk_len(i);
+}
+
+int main(void)
+{
+    gimli_stream_state s;
+    size_t i;
+
+    for (i = 0; i < LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 3);
+    }
+
+    gimli_stream_init(&s, prefix, key);
+    for (i = 0; i < CHUNKS; ++i)
+    {
+        unsigned char *const c = chunk_at(i);
+        assert(gimli_stream_encrypt_next(&s, c, c + chunk_len(i),
+                                         &msg[i * CHUNK], chunk_len(i),
+                                         i == CHUNKS - 1));
+    }
+    /* Nothing can follow the last chunk. */
+    assert(!gimli_stream_encrypt_next(&s, out, out, msg, 1, true));
+
+    /* Each chunk is released as soon as it is checked. */
+    gimli_stream_init(&s, prefix, key);
+    for (i = 0; i < CHUNKS; ++i)
+    {
+        assert(gimli_stream_decrypt_next(&s, out, chunk_at(i), chunk_len(i),
+                                         tag_at(i), i == CHUNKS - 1));
+        assert(memcmp(out, &msg[i * CHUNK], chunk_len(i)) == 0);
+    }
+
+    /* Random access. */
+    assert(gimli_stream_decrypt_chunk(out, chunk_at(2), CHUNK, tag_at(2), 2,
+                                      false, prefix, key));
+    assert(memcmp(out, &msg[2 * CHUNK], CHUNK) == 0);
+
+    /* A chunk in the wrong place, or a truncated stream, is rejected. */
+    assert(!gimli_stream_decrypt_chunk(out, chunk_at(2), CHUNK, tag_at(2), 3,
+                                       false, prefix, key));
+    assert(!gimli_stream_decrypt_chunk(out, chunk_at(2), CHUNK, tag_at(2), 2,
+                                       true, prefix, key));
+    for (i = 0; i < CHUNK; ++i)
+    {
+        assert(out[i] == 0);
+    }
+
+    /* Decryption stops at the first bad chunk. */
+    chunk_at(1)[0] ^= 1;
+    gimli_stream_init(&s, prefix, key);
+    assert(gimli_stream_decrypt_next(&s, out, chunk_at(0), CHUNK, tag_at(0),
+                                     false));
+    assert(!gimli_stream_decrypt_next(&s, out, chunk_at(1), CHUNK, tag_at(1),
+                                      false));
+    chunk_at(1)[0] ^= 1;
+    assert(!gimli_stream_decrypt_next(&s, out, chunk_at(1), CHUNK, tag_at(1),
+                                      false));
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_strobe.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define PROTO "liblithium test protocol"
+
+static const unsigned char key[32] = {1, 2, 3};
+static const unsigned char request[] = "a request that spans several blocks";
+static const unsigned char reply[] = "reply";
+
+static void start(gimli_strobe_state *s)
+{
+    gimli_strobe_init(s, (const unsigned char *)PROTO, sizeof PROTO - 1);
+    gimli_strobe_key(s, key, sizeof key);
+    gimli_strobe_ad(s, (const unsigned char *)"session 1", 9, false);
+}
+
+/* A request and a reply between the two parties. */
+static void check_session(void)
+{
+    gimli_strobe_state a, b;
+    unsigned char c[sizeof request], m[sizeof request];
+    unsigned char t[GIMLI_STROBE_MAC_LEN];
+    unsigned char ka[32], kb[32];
+
+    start(&a);
+    start(&b);
+
+    gimli_strobe_send_enc(&a, c, request, sizeof request, false);
+    gimli_strobe_send_mac(&a, t, sizeof t);
+    assert(memcmp(c, request, sizeof request) != 0);
+    gimli_strobe_recv_enc(&b, m, c, sizeof c, false);
+    assert(gimli_strobe_recv_mac(&b, t, sizeof t));
+    assert(memcmp(m, request, sizeof request) == 0);
+
+    /* The responder sends back, in place and in pieces. */
+    (void)memcpy(c, reply, sizeof reply);
+    gimli_strobe_send_enc(&b, c, c, 2, false);
+    gimli_strobe_send_enc(&b, &c[2], &c[2], sizeof reply - 2, true);
+    gimli_strobe_send_mac(&b, t, sizeof t);
+    gimli_strobe_recv_enc(&a, m, c, sizeof reply, false);
+    assert(gimli_strobe_recv_mac(&a, t, sizeof t));
+    assert(memcmp(m, reply, sizeof reply) == 0);
+
+    gimli_strobe_prf(&a, ka, sizeof ka, false);
+    gimli_strobe_prf(&b, kb, sizeof kb, false);
+    assert(memcmp(ka, kb, sizeof ka) == 0);
+}
+
+static void check_tamper(void)
+{
+    gimli_strobe_state a, b;
+    unsigned char c[sizeof request], m[sizeof request];
+    unsigned char t[GIMLI_STROBE_MAC_LEN];
+
+    start(&a);
+    start(&b);
+    gimli_strobe_send_enc(&a, c, request, sizeof request, false);
+    gimli_strobe_send_mac(&a, t, sizeof t);
+    c[sizeof c - 1] ^= 1;
+    gimli_strobe_recv_enc(&b, m, c, sizeof c, false);
+    assert(!gimli_strobe_recv_mac(&b, t, sizeof t));
+}
+
+/*
+ * Continuing an operation is the same as a single call, and differs from
+ * starting a new operation.
+ */
+static void check_framing(void)
+{
+    gimli_strobe_state a, b, c;
+    unsigned char oa[16], ob[16], oc[16];
+
+    start(&a);
+    start(&b);
+    start(&c);
+    gimli_strobe_ad(&a, request, sizeof request, false);
+    gimli_strobe_ad(&b, request, 5, false);
+    gimli_strobe_ad(&b, &request[5], sizeof request - 5, true);
+    gimli_strobe_ad(&c, request, 5, false);
+    gimli_strobe_ad(&c, &request[5], sizeof request - 5, false);
+    gimli_strobe_prf(&a, oa, sizeof oa, false);
+    gimli_strobe_prf(&b, ob, sizeof ob, false);
+    gimli_strobe_prf(&c, oc, sizeof oc, false);
+    assert(memcmp(oa, ob, sizeof oa) == 0);
+    assert(memcmp(oa, oc, sizeof oa) != 0);
+}
+
+int main(void)
+{
+    check_session();
+    check_tamper();
+    check_framing();
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_tree.h>
+#include <lithium/sign.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define LEAF GIMLI_TREE_LEAF_LEN
+#define MAX_LEN (40 * LEAF + 7)
+
+static unsigned char msg[MAX_LEN];
+
+/* The RFC 6962 recursion, built from gimli_tree_leaf and gimli_tree_parent. */
+static void reference(unsigned char h[GIMLI_TREE_HASH_LEN],
+                      const unsigned char *m, size_t len)
+{
+    unsigned char l[GIMLI_TREE_HASH_LEN], r[GIMLI_TREE_HASH_LEN];
+    size_t k = LEAF;
+    if (len <= LEAF)
+    {
+        gimli_tree_leaf(h, m, len);
+        return;
+    }
+    while (k * 2 < len)
+    {
+        k *= 2;
+    }
+    reference(l, m, k);
+    reference(r, &m[k], len - k);
+    gimli_tree_parent(h, l, r);
+}
+
+static void check_len(size_t len)
+{
+    static const size_t pieces[] = {1000, LEAF, 5000, 70000};
+    unsigned char h1[GIMLI_TREE_HASH_LEN], h2[GIMLI_TREE_HASH_LEN];
+    size_t p, i;
+
+    reference(h1, msg, len);
+    gimli_tree_hash(h2, msg, len);
+    assert(memcmp(h1, h2, sizeof h1) == 0);
+
+    for (p = 0; p < sizeof pieces / sizeof pieces[0]; ++p)
+    {
+        gimli_tree_state g;
+        gimli_tree_init(&g);
+        for (i = 0; i < len; i += pieces[p])
+        {
+            gimli_tree_update(&g, &msg[i],
+                              (len - i < pieces[p]) ? len - i : pieces[p]);
+        }
+        gimli_tree_final(&g, h2);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+    }
+}
+
+int main(void)
+{
+    static const size_t lens[] = {
+        0, 1, LEAF - 1, LEAF, LEAF + 1, 2 * LEAF, 3 * LEAF + 5, 16 * LEAF,
+        17 * LEAF + 100, MAX_LEN,
+    };
+    unsigned char pk[LITH_SIGN_PUBLIC_KEY_LEN], sk[LITH_SIGN_SECRET_KEY_LEN];
+    unsigned char sig[LITH_SIGN_LEN];
+    unsigned char root[GIMLI_TREE_HASH_LEN], sub[GIMLI_TREE_HASH_LEN];
+    gimli_tree_state g;
+    size_t i;
+
+    for (i = 0; i < MAX_LEN; ++i)
+    {
+        msg[i] = (unsigned char)(i * 7 + (i >> 12));
+    }
+    for (i = 0; i < sizeof lens / sizeof lens[0]; ++i)
+    {
+        check_len(lens[i]);
+    }
+
+    /* Subtrees hashed separately, as on other threads, give the same root. */
+    gimli_tree_init(&g);
+    gimli_tree_hash(sub, msg, 32 * LEAF);
+    assert(gimli_tree_update_subtree(&g, sub, 32));
+    gimli_tree_hash(sub, &msg[32 * LEAF], 4 * LEAF);
+    assert(gimli_tree_update_subtree(&g, sub, 4));
+    gimli_tree_hash(sub, &msg[36 * LEAF], 4 * LEAF);
+    assert(gimli_tree_update_subtree(&g, sub, 4));
+    gimli_tree_update(&g, &msg[40 * LEAF], 7);
+    /* Subtrees can't be added after a partial leaf. */
+    assert(!gimli_tree_update_subtree(&g, sub, 1));
+    gimli_tree_final(&g, sub);
+    gimli_tree_hash(root, msg, MAX_LEN);
+    assert(memcmp(root, sub, sizeof root) == 0);
+
+    /* Empty, uneven, and misaligned subtrees are refused. */
+    gimli_tree_init(&g);
+    assert(!gimli_tree_update_subtree(&g, sub, 0));
+    assert(!gimli_tree_update_subtree(&g, sub, 3));
+    assert(gimli_tree_update_subtree(&g, sub, 2));
+    assert(!gimli_tree_update_subtree(&g, sub, 4));
+    assert(gimli_tree_update_subtree(&g, sub, 2));
+    assert(g.depth == 1);
+
+    /* The leaf count can't overflow. */
+    gimli_tree_init(&g);
+    assert(gimli_tree_update_subtree(&g, sub, UINT64_C(1) << 63));
+    assert(!gimli_tree_update_subtree(&g, sub, UINT64_C(1) << 63));
+    assert(g.depth == 1);
+
+    lith_sign_keygen(pk, sk);
+    lith_sign_create_tree_root(sig, root, sk);
+    assert(lith_sign_verify_tree_root(sig, root, pk));
+    assert(!lith_sign_verify(sig, root, sizeof root, pk));
+    root[0] ^= 1;
+    assert(!lith_sign_verify_tree_root(sig, root, pk));
+}
@@ -0,0 +1,124 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_verity.h>
+#include <lithium/sign.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define LEAF GIMLI_TREE_LEAF_LEN
+#define MAX_BLOCKS 37U
+#define MAX_NODES (2 * MAX_BLOCKS + 8)
+
+static unsigned char image[MAX_BLOCKS * LEAF];
+static unsigned char nodes[MAX_NODES * GIMLI_TREE_HASH_LEN];
+static unsigned char verified[(MAX_NODES + 7) / 8];
+
+static size_t block_len(size_t len, uint64_t i)
+{
+    const size_t pos = (size_t)i * LEAF;
+    return ((len - pos) < LEAF) ? len - pos : LEAF;
+}
+
+static void check_len(size_t len)
+{
+    unsigned char root[GIMLI_TREE_HASH_LEN], tree_root[GIMLI_TREE_HASH_LEN];
+    const uint64_t blocks = gimli_verity_blocks(len);
+    gimli_verity_state v;
+    uint64_t i;
+
+    assert(gimli_verity_nodes(blocks) <= MAX_NODES);
+    gimli_verity_build(nodes, root, image, len);
+    gimli_tree_hash(tree_root, image, len);
+    assert(memcmp(root, tree_root, sizeof root) == 0);
+
+    /* Without a cache, each block is checked up to the root. */
+    gimli_verity_init(&v, root, nodes, blocks, NULL);
+    for (i = 0; i < blocks; ++i)
+    {
+        const unsigned char *const block = &image[i * LEAF];
+        const size_t n = block_len(len, i);
+        assert(gimli_verity_verify_block(&v, i, block, n));
+        if (n > 0)
+        {
+            image[i * LEAF] ^= 1;
+            assert(!gimli_verity_verify_block(&v, i, block, n));
+            image[i * LEAF] ^= 1;
+        }
+        if ((i ^ 1) < blocks)
+        {
+            /* Corrupt the stored sibling of the block. */
+            unsigned char *const sibling =
+                &nodes[(i ^ 1) * GIMLI_TREE_HASH_LEN];
+            sibling[0] ^= 1;
+            assert(!gimli_verity_verify_block(&v, i, block, n));
+            sibling[0] ^= 1;
+        }
+    }
+    assert(!gimli_verity_verify_block(&v, blocks, image, 0));
+
+    /* With a cache, in a scattered order. */
+    (void)memset(verified, 0, sizeof verified);
+    gimli_verity_init(&v, root, nodes, blocks, verified);
+    for (i = 0; i < blocks; ++i)
+    {
+        const uint64_t b = (i * 7) % blocks;
+        assert(gimli_verity_verify_block(&v, b, &image[b * LEAF],
+                                         block_len(len, b)));
+        if (block_len(len, b) > 0)
+        {
+            /* A cached path must not accept a modified block. */
+            image[b * LEAF] ^= 1;
+            assert(!gimli_verity_verify_block(&v, b, &image[b * LEAF],
+                                              block_len(len, b)));
+            image[b * LEAF] ^= 1;
+        }
+    }
+
+    /* A wrong root rejects every block. */
+    root[0] ^= 1;
+    gimli_verity_init(&v, root, nodes, blocks, NULL);
+    assert(!gimli_verity_verify_block(&v, 0, image, block_len(len, 0)));
+}
+
+static void check_signed_root(void)
+{
+    unsigned char pk[LITH_SIGN_PUBLIC_KEY_LEN], sk[LITH_SIGN_SECRET_KEY_LEN];
+    unsigned char sig[LITH_SIGN_LEN], root[GIMLI_TREE_HASH_LEN];
+    unsigned char cache[(MAX_NODES + 7) / 8];
+    gimli_verity_state v;
+    const size_t len = 9 * LEAF + 100;
+
+    lith_sign_keygen(pk, sk);
+    gimli_verity_build(nodes, root, image, len);
+    lith_sign_create_tree_root(sig, root, sk);
+
+    /* The reader only trusts the root after checking its signature. */
+    assert(lith_sign_verify_tree_root(sig, root, pk));
+    (void)memset(cache, 0, sizeof cache);
+    gimli_verity_init(&v, root, nodes, gimli_verity_blocks(len), cache);
+    assert(gimli_verity_verify_block(&v, 9, &image[9 * LEAF], 100));
+    assert(gimli_verity_verify_block(&v, 3, &image[3 * LEAF], LEAF));
+}
+
+int main(void)
+{
+    static const size_t lens[] = {
+        0, 1, LEAF, LEAF + 1, 5 * LEAF + 3, 16 * LEAF, 17 * LEAF, 37 * LEAF,
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof image; ++i)
+    {
+        image[i] = (unsigned char)(i * 131 + (i >> 12));
+    }
+    for (i = 0; i < sizeof lens / sizeof lens[0]; ++i)
+    {
+        check_len(lens[i]);
+    }
+    check_signed_root();
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Part of liblithium, under the Apache License v2.0.
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <lithium/gimli_aead.h>
+#include <lithium/gimli_hash.h>
+
+#include <assert.h>
+#include <string.h>
+
+#define NWORDS 40
+
+static void store_words(unsigned char *p, const uint32_t *w, size_t nwords)
+{
+    size_t i;
+    for (i = 0; i < nwords * 4; ++i)
+    {
+        p[i] = (unsigned char)((w[i / 4] >> ((i % 4) * 8)) & 0xFFU);
+    }
+}
+
+/*
+ * After a byte update of every length from 0 to 5 bytes, so that the words
+ * start both on and off word boundaries, check that the word functions match
+ * the byte functions on the little-endian encoding of the words.
+ */
+int main(void)
+{
+    static const unsigned char n[GIMLI_AEAD_NONCE_LEN] = {1, 2, 3};
+    static const unsigned char k[GIMLI_AEAD_KEY_LEN] = {4, 5, 6};
+    static const unsigned char prefix[5] = {7, 8, 9, 10, 11};
+    uint32_t mw[NWORDS], cw[NWORDS], dw[NWORDS];
+    unsigned char mb[NWORDS * 4], cb[NWORDS * 4], tmp[NWORDS * 4];
+    unsigned char h1[GIMLI_HASH_DEFAULT_LEN], h2[GIMLI_HASH_DEFAULT_LEN];
+    size_t plen, i;
+
+    for (i = 0; i < NWORDS; ++i)
+    {
+        mw[i] = (uint32_t)(i * 0x9E3779B9UL + 1);
+    }
+    store_words(mb, mw, NWORDS);
+
+    for (plen = 0; plen <= sizeof prefix; ++plen)
+    {
+        gimli_hash_state hs;
+        gimli_state as;
+
+        gimli_hash_init(&hs);
+        gimli_hash_update(&hs, prefix, plen);
+        gimli_hash_update(&hs, mb, sizeof mb);
+        gimli_hash_final(&hs, h1, sizeof h1);
+        gimli_hash_init(&hs);
+        gimli_hash_update(&hs, prefix, plen);
+        gimli_hash_update_words(&hs, mw, NWORDS);
+        gimli_hash_final(&hs, h2, sizeof h2);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+
+        gimli_aead_init(&as, n, k);
+        gimli_aead_update_ad(&as, prefix, plen);
+        gimli_aead_update_ad(&as, mb, sizeof mb);
+        gimli_aead_final_ad(&as);
+        gimli_aead_encrypt_update(&as, tmp, prefix, plen);
+        gimli_aead_encrypt_update(&as, cb, mb, sizeof mb);
+        gimli_aead_encrypt_final(&as, h1, sizeof h1);
+
+        gimli_aead_init(&as, n, k);
+        gimli_aead_update_ad(&as, prefix, plen);
+        gimli_aead_update_ad_words(&as, mw, NWORDS);
+        gimli_aead_final_ad(&as);
+        gimli_aead_encrypt_update(&as, tmp, prefix, plen);
+        gimli_aead_encrypt_update_words(&as, cw, mw, NWORDS);
+        gimli_aead_encrypt_final(&as, h2, sizeof h2);
+        store_words(tmp, cw, NWORDS);
+        assert(memcmp(cb, tmp, sizeof cb) == 0);
+        assert(memcmp(h1, h2, sizeof h1) == 0);
+
+        gimli_aead_init(&as, n, k);
+        gimli_aead_update_ad(&as, prefix, plen);
+        gimli_aead_update_ad_words(&as, mw, NWORDS);
+        gimli_aead_final_ad(&as);
+        gimli_aead_encrypt_update(&as, tmp, prefix, plen);
+        gimli_aead_decrypt_update_words(&as, dw, cw, NWORDS);
+        assert(gimli_aead_decrypt_final(&as, h1, sizeof h1));
+        assert(memcmp(mw, dw, sizeof mw) == 0);
+    }
+}